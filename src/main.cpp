@@ -9,6 +9,8 @@
 #include <Server/Components/Pawn/pawn.hpp>
 #include <Server/Components/Pawn/Impl/pawn_natives.hpp>
 #include <Server/Components/Pawn/Impl/pawn_impl.hpp>
+#include <Server/Components/Vehicles/vehicles.hpp>
+#include <Server/Components/Objects/objects.hpp>
 
 #include <chrono>
 #include <cstring>
@@ -19,6 +21,27 @@ static inline cell* GetArrayPtr(AMX* amx, cell param) {
     return addr;
 }
 
+// Copy an unpacked Pawn string into a char buffer (always terminated)
+static inline int GetString(cell* src, char* buf, int bufSize) {
+    int i;
+    for (i = 0; i < bufSize - 1 && src[i] != 0; i++) {
+        buf[i] = static_cast<char>(src[i]);
+    }
+    buf[i] = '\0';
+    return i;
+}
+
+// Resolve row `index` of a 2D Pawn array via its indirection table
+static inline cell* GetArrayRow(cell* base, int index) {
+    return reinterpret_cast<cell*>(reinterpret_cast<char*>(base + index) + base[index]);
+}
+
+// Row count of a 2D Pawn array: row 0's data starts right after the
+// indirection table, so its offset is the table size in bytes
+static inline int GetArrayRowCount(cell* base) {
+    return static_cast<int>(base[0] / static_cast<cell>(sizeof(cell)));
+}
+
 // Core random functions
 
 SCRIPT_API(RandRange, int(int min, int max)) {
@@ -42,27 +65,51 @@ SCRIPT_API(RandBoolWeighted, bool(int trueWeight, int falseWeight)) {
     return ImplRandBoolWeighted(trueWeight, falseWeight);
 }
 
-SCRIPT_API(RandWeighted, int(cell weightsAddr, int count)) {
-    if (count <= 0) return 0;
+SCRIPT_API(RandShuffleRange, bool(cell arrayAddr, int start, int end)) {
+    cell* array = GetArrayPtr(GetAMX(), arrayAddr);
+    if (!array) return false;
+
+    return ImplRandShuffleRange(reinterpret_cast<int*>(array), start, end);
+}
+
+SCRIPT_API(RandShuffleThreads, bool(int threads)) {
+    return ImplRandShuffleThreads(threads);
+}
+
+// Only global/static arrays (below the heap) outlive the calling function
+SCRIPT_API(RandShuffleBegin, int(cell arrayAddr, int count, int budgetMicros)) {
+    AMX* amx = GetAMX();
+    // The whole array must lie below the heap, not just its first cell
+    int64_t bytes = static_cast<int64_t>(count) * static_cast<int64_t>(sizeof(cell));
+    if (arrayAddr < 0 || count <= 0 || arrayAddr + bytes > amx->hlw) return 0;
     
-    cell* weights = GetArrayPtr(GetAMX(), weightsAddr);
-    if (!weights) return 0;
+    cell* array = GetArrayPtr(amx, arrayAddr);
+    if (!array) return 0;
     
-    return ImplRandWeighted(reinterpret_cast<int*>(weights), count);
+    return ImplRandShuffleBegin(amx, array, count, budgetMicros);
 }
 
-SCRIPT_API(RandShuffle, bool(cell arrayAddr, int count)) {
-    cell* array = GetArrayPtr(GetAMX(), arrayAddr);
-    if (!array) return false;
-    
-    return ImplRandShuffle(reinterpret_cast<int*>(array), count);
+SCRIPT_API(RandShuffleProgress, int(int handle)) {
+    return ImplRandShuffleProgress(handle);
 }
 
-SCRIPT_API(RandShuffleRange, bool(cell arrayAddr, int start, int end)) {
-    cell* array = GetArrayPtr(GetAMX(), arrayAddr);
-    if (!array) return false;
+SCRIPT_API(RandShuffleCancel, bool(int handle)) {
+    return ImplRandShuffleCancel(handle);
+}
 
-    return ImplRandShuffleRange(reinterpret_cast<int*>(array), start, end);
+SCRIPT_API(RandShuffleRows, bool(cell arrayAddr, int rowCount, int cols)) {
+    if (rowCount <= 1) return true;
+    if (rowCount > 1000000) return false;
+    
+    cell* base = GetArrayPtr(GetAMX(), arrayAddr);
+    if (!base || rowCount > GetArrayRowCount(base)) return false;
+    if (cols > GetArrayRow(base, 1) - GetArrayRow(base, 0)) return false;
+    
+    std::vector<int*> rows(static_cast<size_t>(rowCount));
+    for (int i = 0; i < rowCount; i++) {
+        rows[i] = reinterpret_cast<int*>(GetArrayRow(base, i));
+    }
+    return ImplRandShuffleRows(rows.data(), rowCount, cols);
 }
 
 SCRIPT_API(RandGaussian, int(float mean, float stddev)) {
@@ -73,15 +120,6 @@ SCRIPT_API(RandDice, int(int sides, int count)) {
     return ImplRandDice(sides, count);
 }
 
-SCRIPT_API(RandPick, int(cell arrayAddr, int count)) {
-    if (count <= 0) return 0;
-    
-    cell* array = GetArrayPtr(GetAMX(), arrayAddr);
-    if (!array) return 0;
-    
-    return ImplRandPick(reinterpret_cast<int*>(array), count);
-}
-
 SCRIPT_API(RandFormat, bool(cell destAddr, cell patternAddr, int destSize)) {
     cell* dest = GetArrayPtr(GetAMX(), destAddr);
     cell* pattern = GetArrayPtr(GetAMX(), patternAddr);
@@ -111,6 +149,25 @@ SCRIPT_API(RandFormat, bool(cell destAddr, cell patternAddr, int destSize)) {
     return true;
 }
 
+SCRIPT_API(RandFormatChecked, bool(cell destAddr, cell patternAddr, int destSize)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    cell* pattern = GetArrayPtr(GetAMX(), patternAddr);
+    if (!dest || !pattern || destSize <= 0) return false;
+    
+    char patternBuf[256];
+    GetString(pattern, patternBuf, sizeof(patternBuf));
+    
+    char destBuf[1024];
+    if (!ImplRandFormat(destBuf, patternBuf, sizeof(destBuf), true)) return false;
+    
+    int i;
+    for (i = 0; destBuf[i] != '\0' && i < destSize - 1; i++) {
+        dest[i] = static_cast<cell>(destBuf[i]);
+    }
+    dest[i] = '\0';
+    return true;
+}
+
 // Cryptographic functions
 
 SCRIPT_API(RandBytes, bool(cell destAddr, int length)) {
@@ -143,6 +200,808 @@ SCRIPT_API(RandUUID, bool(cell destAddr)) {
     return true;
 }
 
+SCRIPT_API(RandUUIDv7, bool(cell destAddr)) {
+    cell* out = GetArrayPtr(GetAMX(), destAddr);
+    if (!out) return false;
+
+    char uuidBuf[40];
+    if (!ImplRandUUIDv7(uuidBuf)) return false;
+    
+    for (int i = 0; uuidBuf[i] != '\0'; i++) {
+        out[i] = static_cast<cell>(uuidBuf[i]);
+    }
+    out[36] = 0;
+    return true;
+}
+
+SCRIPT_API(RandUUIDBulk, int(cell destAddr, int count, int version)) {
+    if (count <= 0) return 0;
+    
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest || count > GetArrayRowCount(dest)) return 0;
+    
+    return ImplRandUUIDBulk(count, version, [dest](int index, const char* uuid) {
+        cell* row = GetArrayRow(dest, index);
+        for (int i = 0; i < 36; i++) {
+            row[i] = static_cast<cell>(uuid[i]);
+        }
+        row[36] = 0;
+    });
+}
+
+SCRIPT_API(RandTokenBase64, int(cell destAddr, int bytes, int destSize, int filter)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest) return 0;
+    
+    return ImplRandToken(dest, destSize, bytes, TokenEncoding::Base64Url, filter);
+}
+
+SCRIPT_API(RandTokenBase32, int(cell destAddr, int bytes, int destSize, int filter)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest) return 0;
+    
+    return ImplRandToken(dest, destSize, bytes, TokenEncoding::Base32, filter);
+}
+
+SCRIPT_API(RandTokenCrockford, int(cell destAddr, int bytes, int destSize, int filter)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest) return 0;
+    
+    return ImplRandToken(dest, destSize, bytes, TokenEncoding::Crockford, filter);
+}
+
+SCRIPT_API(RandCodeVerify, bool(cell codeAddr, int algorithm)) {
+    cell* code = GetArrayPtr(GetAMX(), codeAddr);
+    if (!code) return false;
+    
+    char codeBuf[256];
+    GetString(code, codeBuf, sizeof(codeBuf));
+    return ImplRandCodeVerify(codeBuf, algorithm);
+}
+
+// Blocklist filters
+
+SCRIPT_API(RandFilterCreate, int(bool leet)) {
+    return ImplRandFilterCreate(leet);
+}
+
+SCRIPT_API(RandFilterAddWord, bool(int handle, cell wordAddr)) {
+    cell* word = GetArrayPtr(GetAMX(), wordAddr);
+    if (!word) return false;
+    
+    char wordBuf[256];
+    GetString(word, wordBuf, sizeof(wordBuf));
+    return ImplRandFilterAddWord(handle, wordBuf);
+}
+
+SCRIPT_API(RandFilterLoad, int(cell filenameAddr, bool leet)) {
+    cell* filename = GetArrayPtr(GetAMX(), filenameAddr);
+    if (!filename) return 0;
+    
+    char nameBuf[256];
+    GetString(filename, nameBuf, sizeof(nameBuf));
+    return ImplRandFilterLoad(nameBuf, leet);
+}
+
+SCRIPT_API(RandFilterCheck, bool(int handle, cell textAddr)) {
+    cell* text = GetArrayPtr(GetAMX(), textAddr);
+    if (!text) return false;
+    
+    char textBuf[1024];
+    GetString(text, textBuf, sizeof(textBuf));
+    return ImplRandFilterCheck(handle, textBuf);
+}
+
+SCRIPT_API(RandFilterWordCount, int(int handle)) {
+    return ImplRandFilterWordCount(handle);
+}
+
+SCRIPT_API(RandFilterDestroy, bool(int handle)) {
+    return ImplRandFilterDestroy(handle);
+}
+
+SCRIPT_API(RandFormatFiltered, bool(int filter, cell destAddr, cell patternAddr, int destSize)) {
+    if (destSize <= 0) return false;
+    
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    cell* pattern = GetArrayPtr(GetAMX(), patternAddr);
+    if (!dest || !pattern) return false;
+    
+    char patternBuf[256];
+    GetString(pattern, patternBuf, sizeof(patternBuf));
+    
+    char destBuf[256];
+    if (destSize > static_cast<int>(sizeof(destBuf))) destSize = sizeof(destBuf);
+    if (!ImplRandFormatFiltered(filter, destBuf, patternBuf, destSize)) return false;
+    
+    int i;
+    for (i = 0; destBuf[i] != '\0'; i++) {
+        dest[i] = static_cast<cell>(destBuf[i]);
+    }
+    dest[i] = 0;
+    return true;
+}
+
+// Reverse regex
+
+SCRIPT_API(RandRegexCompile, int(cell patternAddr)) {
+    cell* pattern = GetArrayPtr(GetAMX(), patternAddr);
+    if (!pattern) return 0;
+    
+    char patternBuf[512];
+    GetString(pattern, patternBuf, sizeof(patternBuf));
+    return ImplRandRegexCompile(patternBuf);
+}
+
+SCRIPT_API(RandRegex, int(int handle, cell destAddr, int destSize)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest) return -1;
+    
+    return ImplRandRegex(handle, dest, destSize);
+}
+
+SCRIPT_API(RandRegexMaxLength, int(int handle)) {
+    return ImplRandRegexMaxLength(handle);
+}
+
+SCRIPT_API(RandRegexDestroy, bool(int handle)) {
+    return ImplRandRegexDestroy(handle);
+}
+
+// Token registries
+
+SCRIPT_API(RandRegistryCreate, int(int capacity, bool exact)) {
+    return ImplRandRegistryCreate(capacity, exact);
+}
+
+SCRIPT_API(RandRegistryAdd, int(int handle, cell tokenAddr)) {
+    cell* token = GetArrayPtr(GetAMX(), tokenAddr);
+    if (!token) return -1;
+    
+    char tokenBuf[256];
+    GetString(token, tokenBuf, sizeof(tokenBuf));
+    return ImplRandRegistryAdd(handle, tokenBuf);
+}
+
+SCRIPT_API(RandRegistryContains, bool(int handle, cell tokenAddr)) {
+    cell* token = GetArrayPtr(GetAMX(), tokenAddr);
+    if (!token) return false;
+    
+    char tokenBuf[256];
+    GetString(token, tokenBuf, sizeof(tokenBuf));
+    return ImplRandRegistryContains(handle, tokenBuf);
+}
+
+SCRIPT_API(RandRegistryRemove, bool(int handle, cell tokenAddr)) {
+    cell* token = GetArrayPtr(GetAMX(), tokenAddr);
+    if (!token) return false;
+    
+    char tokenBuf[256];
+    GetString(token, tokenBuf, sizeof(tokenBuf));
+    return ImplRandRegistryRemove(handle, tokenBuf);
+}
+
+SCRIPT_API(RandRegistryCount, int(int handle)) {
+    return ImplRandRegistryCount(handle);
+}
+
+SCRIPT_API(RandRegistrySave, bool(int handle, cell filenameAddr)) {
+    cell* filename = GetArrayPtr(GetAMX(), filenameAddr);
+    if (!filename) return false;
+    
+    char nameBuf[256];
+    GetString(filename, nameBuf, sizeof(nameBuf));
+    return ImplRandRegistrySave(handle, nameBuf);
+}
+
+SCRIPT_API(RandRegistryLoad, int(cell filenameAddr)) {
+    cell* filename = GetArrayPtr(GetAMX(), filenameAddr);
+    if (!filename) return 0;
+    
+    char nameBuf[256];
+    GetString(filename, nameBuf, sizeof(nameBuf));
+    return ImplRandRegistryLoad(nameBuf);
+}
+
+SCRIPT_API(RandRegistryDestroy, bool(int handle)) {
+    return ImplRandRegistryDestroy(handle);
+}
+
+SCRIPT_API(RandFormatUnique, bool(int handle, cell destAddr, cell patternAddr, int maxAttempts, int destSize)) {
+    if (destSize <= 0) return false;
+    
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    cell* pattern = GetArrayPtr(GetAMX(), patternAddr);
+    if (!dest || !pattern) return false;
+    
+    char patternBuf[256];
+    GetString(pattern, patternBuf, sizeof(patternBuf));
+    
+    char destBuf[256];
+    if (destSize > static_cast<int>(sizeof(destBuf))) destSize = sizeof(destBuf);
+    if (!ImplRandFormatUnique(handle, destBuf, patternBuf, destSize, maxAttempts)) return false;
+    
+    int i;
+    for (i = 0; destBuf[i] != '\0'; i++) {
+        dest[i] = static_cast<cell>(destBuf[i]);
+    }
+    dest[i] = 0;
+    return true;
+}
+
+// Lazy permutations
+
+SCRIPT_API(RandPermCreate, int(int n, int seed)) {
+    return ImplRandPermCreate(n, static_cast<uint32_t>(seed));
+}
+
+SCRIPT_API(RandPermAt, int(int handle, int index)) {
+    return ImplRandPermAt(handle, index);
+}
+
+SCRIPT_API(RandPermIndexOf, int(int handle, int value)) {
+    return ImplRandPermIndexOf(handle, value);
+}
+
+SCRIPT_API(RandPermSize, int(int handle)) {
+    return ImplRandPermSize(handle);
+}
+
+SCRIPT_API(RandPermDestroy, bool(int handle)) {
+    return ImplRandPermDestroy(handle);
+}
+
+// Unique codes
+
+SCRIPT_API(RandUniqueCodeCreate, int(cell patternAddr, int seed)) {
+    cell* pattern = GetArrayPtr(GetAMX(), patternAddr);
+    if (!pattern) return 0;
+    
+    char patternBuf[256];
+    GetString(pattern, patternBuf, sizeof(patternBuf));
+    return ImplRandUniqueCodeCreate(patternBuf, static_cast<uint32_t>(seed));
+}
+
+SCRIPT_API(RandUniqueCodeCreateKeyed, int(cell patternAddr, cell secretAddr)) {
+    cell* pattern = GetArrayPtr(GetAMX(), patternAddr);
+    cell* secret = GetArrayPtr(GetAMX(), secretAddr);
+    if (!pattern || !secret) return 0;
+    
+    char patternBuf[256], secretBuf[256];
+    GetString(pattern, patternBuf, sizeof(patternBuf));
+    GetString(secret, secretBuf, sizeof(secretBuf));
+    int handle = ImplRandUniqueCodeCreateKeyed(patternBuf, secretBuf);
+    std::fill(secretBuf, secretBuf + sizeof(secretBuf), 0);
+    return handle;
+}
+
+SCRIPT_API(RandUniqueCode, bool(int handle, int counter, cell destAddr, int destSize)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest) return false;
+    
+    return ImplRandUniqueCode(handle, counter, dest, destSize);
+}
+
+SCRIPT_API(RandUniqueCodeSpace, int(int handle)) {
+    return ImplRandUniqueCodeSpace(handle);
+}
+
+SCRIPT_API(RandUniqueCodeDestroy, bool(int handle)) {
+    return ImplRandUniqueCodeDestroy(handle);
+}
+
+// Markov names
+
+SCRIPT_API(RandMarkovCreate, int(int order)) {
+    return ImplRandMarkovCreate(order);
+}
+
+SCRIPT_API(RandMarkovTrain, bool(int handle, cell nameAddr)) {
+    cell* name = GetArrayPtr(GetAMX(), nameAddr);
+    if (!name) return false;
+    
+    char nameBuf[256];
+    GetString(name, nameBuf, sizeof(nameBuf));
+    return ImplRandMarkovTrain(handle, nameBuf);
+}
+
+SCRIPT_API(RandMarkovLoad, int(cell filenameAddr, int order)) {
+    cell* filename = GetArrayPtr(GetAMX(), filenameAddr);
+    if (!filename) return 0;
+    
+    char nameBuf[256];
+    GetString(filename, nameBuf, sizeof(nameBuf));
+    return ImplRandMarkovLoad(nameBuf, order);
+}
+
+SCRIPT_API(RandMarkovName, int(int handle, cell destAddr, int minLen, int maxLen, cell prefixAddr, bool allowCopies, int destSize)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    cell* prefix = GetArrayPtr(GetAMX(), prefixAddr);
+    if (!dest || !prefix) return -1;
+    
+    char prefixBuf[64];
+    GetString(prefix, prefixBuf, sizeof(prefixBuf));
+    return ImplRandMarkovName(handle, dest, destSize, minLen, maxLen, prefixBuf, allowCopies);
+}
+
+SCRIPT_API(RandMarkovNameCount, int(int handle)) {
+    return ImplRandMarkovNameCount(handle);
+}
+
+SCRIPT_API(RandMarkovDestroy, bool(int handle)) {
+    return ImplRandMarkovDestroy(handle);
+}
+
+// Passphrases
+
+SCRIPT_API(RandPassphrase, int(cell destAddr, int words, cell separatorAddr, cell wordlistAddr, int destSize)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    cell* separator = GetArrayPtr(GetAMX(), separatorAddr);
+    cell* wordlist = GetArrayPtr(GetAMX(), wordlistAddr);
+    if (!dest || !separator || !wordlist) return -1;
+    
+    char sepBuf[16];
+    char listBuf[256];
+    GetString(separator, sepBuf, sizeof(sepBuf));
+    GetString(wordlist, listBuf, sizeof(listBuf));
+    return ImplRandPassphrase(dest, destSize, words, sepBuf, listBuf);
+}
+
+SCRIPT_API(RandPassphraseWordCount, int(cell wordlistAddr)) {
+    cell* wordlist = GetArrayPtr(GetAMX(), wordlistAddr);
+    if (!wordlist) return 0;
+    
+    char listBuf[256];
+    GetString(wordlist, listBuf, sizeof(listBuf));
+    return ImplRandPassphraseWordCount(listBuf);
+}
+
+// Decks
+
+SCRIPT_API(RandDeckCreate, int(cell valuesAddr, int count, bool autoReshuffle)) {
+    cell* values = GetArrayPtr(GetAMX(), valuesAddr);
+    if (!values) return 0;
+    
+    return ImplRandDeckCreate(values, count, autoReshuffle);
+}
+
+SCRIPT_API(RandDeckDraw, bool(int handle, cell outValue)) {
+    cell* valueAddr = GetArrayPtr(GetAMX(), outValue);
+    if (!valueAddr) return false;
+    
+    int32_t value;
+    if (!ImplRandDeckDraw(handle, value)) return false;
+    *valueAddr = value;
+    return true;
+}
+
+SCRIPT_API(RandDeckReturn, bool(int handle, int value)) {
+    return ImplRandDeckReturn(handle, value);
+}
+
+SCRIPT_API(RandDeckReshuffle, bool(int handle)) {
+    return ImplRandDeckReshuffle(handle);
+}
+
+SCRIPT_API(RandDeckRemaining, int(int handle)) {
+    return ImplRandDeckRemaining(handle);
+}
+
+SCRIPT_API(RandDeckSize, int(int handle)) {
+    return ImplRandDeckSize(handle);
+}
+
+SCRIPT_API(RandDeckDestroy, bool(int handle)) {
+    return ImplRandDeckDestroy(handle);
+}
+
+// Unique ranges
+
+SCRIPT_API(RandUniqueRangeCreate, int(int min, int max)) {
+    return ImplRandUniqueRangeCreate(min, max);
+}
+
+SCRIPT_API(RandUniqueNext, bool(int handle, cell outValue)) {
+    cell* valueAddr = GetArrayPtr(GetAMX(), outValue);
+    if (!valueAddr) return false;
+    
+    int32_t value;
+    if (!ImplRandUniqueNext(handle, value)) return false;
+    *valueAddr = value;
+    return true;
+}
+
+SCRIPT_API(RandUniqueRangeRemaining, int(int handle)) {
+    return ImplRandUniqueRangeRemaining(handle);
+}
+
+SCRIPT_API(RandUniqueRangeReset, bool(int handle)) {
+    return ImplRandUniqueRangeReset(handle);
+}
+
+SCRIPT_API(RandUniqueRangeDestroy, bool(int handle)) {
+    return ImplRandUniqueRangeDestroy(handle);
+}
+
+// Exclusion-aware ranges
+
+SCRIPT_API(RandRangeExcluding, int(int min, int max, cell excludedAddr, int count)) {
+    cell* excluded = GetArrayPtr(GetAMX(), excludedAddr);
+    if (!excluded) count = 0;
+    
+    return ImplRandRangeExcluding(min, max, excluded, count);
+}
+
+SCRIPT_API(RandIntSetCreate, int(int min, int max)) {
+    return ImplRandIntSetCreate(min, max);
+}
+
+SCRIPT_API(RandIntSetExclude, bool(int handle, int from, int to)) {
+    return ImplRandIntSetExclude(handle, from, to);
+}
+
+SCRIPT_API(RandIntSetInclude, bool(int handle, int from, int to)) {
+    return ImplRandIntSetInclude(handle, from, to);
+}
+
+SCRIPT_API(RandIntSetContains, bool(int handle, int value)) {
+    return ImplRandIntSetContains(handle, value);
+}
+
+SCRIPT_API(RandIntSetCount, int(int handle)) {
+    return ImplRandIntSetCount(handle);
+}
+
+SCRIPT_API(RandIntSetPick, bool(int handle, cell outValue)) {
+    cell* valueAddr = GetArrayPtr(GetAMX(), outValue);
+    if (!valueAddr) return false;
+    
+    int32_t value;
+    if (!ImplRandIntSetPick(handle, value)) return false;
+    *valueAddr = value;
+    return true;
+}
+
+SCRIPT_API(RandIntSetDestroy, bool(int handle)) {
+    return ImplRandIntSetDestroy(handle);
+}
+
+// Loot tables
+
+SCRIPT_API(RandLootLoad, int(cell filenameAddr)) {
+    cell* filename = GetArrayPtr(GetAMX(), filenameAddr);
+    if (!filename) return 0;
+    
+    char nameBuf[256];
+    GetString(filename, nameBuf, sizeof(nameBuf));
+    return ImplRandLootLoad(nameBuf);
+}
+
+SCRIPT_API(RandLootTable, int(cell nameAddr)) {
+    cell* name = GetArrayPtr(GetAMX(), nameAddr);
+    if (!name) return 0;
+    
+    char nameBuf[128];
+    GetString(name, nameBuf, sizeof(nameBuf));
+    return ImplRandLootTable(nameBuf);
+}
+
+SCRIPT_API(RandLootRoll, int(int table, cell destAddr, int maxCells)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest) return -1;
+    
+    return ImplRandLootRoll(table, dest, maxCells);
+}
+
+// LRU-biased selectors
+
+SCRIPT_API(RandSelectorCreate, int(int count, float decay, int cooldownMs)) {
+    return ImplRandSelectorCreate(count, decay, cooldownMs);
+}
+
+SCRIPT_API(RandSelectorPick, int(int handle)) {
+    return ImplRandSelectorPick(handle);
+}
+
+SCRIPT_API(RandSelectorTouch, bool(int handle, int index)) {
+    return ImplRandSelectorTouch(handle, index);
+}
+
+SCRIPT_API(RandSelectorSetWeight, bool(int handle, int index, float weight)) {
+    return ImplRandSelectorSetWeight(handle, index, weight);
+}
+
+SCRIPT_API(RandSelectorReset, bool(int handle)) {
+    return ImplRandSelectorReset(handle);
+}
+
+SCRIPT_API(RandSelectorDestroy, bool(int handle)) {
+    return ImplRandSelectorDestroy(handle);
+}
+
+// Team balancing
+
+// playersAddr is not read: outTeam is indexed by position
+SCRIPT_API(RandTeams, bool(cell playersAddr, cell scoresAddr, int count, int teams, cell outTeamAddr)) {
+    cell* scores = GetArrayPtr(GetAMX(), scoresAddr);
+    cell* outTeam = GetArrayPtr(GetAMX(), outTeamAddr);
+    if (!scores || !outTeam) return false;
+    
+    return ImplRandTeams(scores, count, teams, outTeam);
+}
+
+// Server entity pools
+// Filters of -1 match anything. Each native is one pass over the pool with
+// reservoir sampling, so no id list is built in Pawn or here.
+
+static constexpr int RANDIX_INVALID_ID = 0xFFFF;   // INVALID_PLAYER/VEHICLE/OBJECT_ID
+
+// Set by the component once the pools exist
+static IPlayerPool* PlayerPool = nullptr;
+static IVehiclesComponent* VehiclePool = nullptr;
+static IObjectsComponent* ObjectPool = nullptr;
+
+struct PlayerFilter {
+    int team, world, state, interior, skin, exceptid;
+    bool includeNPCs;
+    
+    bool Matches(IPlayer& player) const {
+        if (player.getID() == exceptid) return false;
+        if (!includeNPCs && player.isBot()) return false;
+        if (team != -1 && player.getTeam() != team) return false;
+        if (world != -1 && player.getVirtualWorld() != world) return false;
+        if (state != -1 && static_cast<int>(player.getState()) != state) return false;
+        if (interior != -1 && static_cast<int>(player.getInterior()) != interior) return false;
+        if (skin != -1 && player.getSkin() != skin) return false;
+        return true;
+    }
+};
+
+static int SamplePlayers(const PlayerFilter& filter, int32_t* out, int k) {
+    if (!PlayerPool) return 0;
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    Reservoir reservoir(Randomix::GetRNG(), out, k);
+    for (IPlayer* player : PlayerPool->entries()) {
+        if (filter.Matches(*player)) reservoir.Offer(player->getID());
+    }
+    return reservoir.Finish();
+}
+
+static int SampleVehicles(int model, int world, bool emptyOnly, int32_t* out, int k) {
+    if (!VehiclePool) return 0;
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    Reservoir reservoir(Randomix::GetRNG(), out, k);
+    for (IVehicle* vehicle : *VehiclePool) {
+        if (model != -1 && vehicle->getModel() != model) continue;
+        if (world != -1 && vehicle->getVirtualWorld() != world) continue;
+        if (emptyOnly && (vehicle->getDriver() != nullptr || !vehicle->getPassengers().empty())) continue;
+        reservoir.Offer(vehicle->getID());
+    }
+    return reservoir.Finish();
+}
+
+static int SampleObjects(int model, int world, int32_t* out, int k) {
+    if (!ObjectPool) return 0;
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    Reservoir reservoir(Randomix::GetRNG(), out, k);
+    for (IObject* object : *ObjectPool) {
+        if (model != -1 && object->getModel() != model) continue;
+        if (world != -1 && object->getVirtualWorld() != world) continue;
+        reservoir.Offer(object->getID());
+    }
+    return reservoir.Finish();
+}
+
+SCRIPT_API(RandPlayer, int(int team, int world, int state, int interior, int skin, int exceptid, bool includeNPCs)) {
+    int32_t id;
+    PlayerFilter filter{team, world, state, interior, skin, exceptid, includeNPCs};
+    return SamplePlayers(filter, &id, 1) ? id : RANDIX_INVALID_ID;
+}
+
+SCRIPT_API(RandPlayers, int(cell destAddr, int maxCount, int team, int world, int state, int interior, int skin, int exceptid, bool includeNPCs)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest || maxCount <= 0) return 0;
+    
+    PlayerFilter filter{team, world, state, interior, skin, exceptid, includeNPCs};
+    return SamplePlayers(filter, dest, maxCount);
+}
+
+SCRIPT_API(RandVehicle, int(int model, int world, bool emptyOnly)) {
+    int32_t id;
+    return SampleVehicles(model, world, emptyOnly, &id, 1) ? id : RANDIX_INVALID_ID;
+}
+
+SCRIPT_API(RandVehicles, int(cell destAddr, int maxCount, int model, int world, bool emptyOnly)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest || maxCount <= 0) return 0;
+    
+    return SampleVehicles(model, world, emptyOnly, dest, maxCount);
+}
+
+SCRIPT_API(RandObject, int(int model, int world)) {
+    int32_t id;
+    return SampleObjects(model, world, &id, 1) ? id : RANDIX_INVALID_ID;
+}
+
+SCRIPT_API(RandObjects, int(cell destAddr, int maxCount, int model, int world)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest || maxCount <= 0) return 0;
+    
+    return SampleObjects(model, world, dest, maxCount);
+}
+
+// Entities within a radius
+// Positions are snapshotted into a spatial grid by the first query of each
+// server tick and reused by later queries in the same tick, so moves made
+// earlier in the same tick (SetPlayerPos etc.) are not seen until the next.
+// Disconnects and vehicle destruction invalidate the snapshot, and every hit
+// is re-checked against the pool before it is returned.
+
+static SpatialGrid PlayerGrid;
+static SpatialGrid VehicleGrid;
+static bool PlayerGridStale = true;
+static bool VehicleGridStale = true;
+
+static const SpatialGrid& CurrentPlayerGrid() {
+    if (PlayerGridStale && PlayerPool) {
+        PlayerGrid.Clear();
+        for (IPlayer* player : PlayerPool->entries()) {
+            Vector3 pos = player->getPosition();
+            uint32_t flags = (static_cast<uint32_t>(player->getState()) << 1) | (player->isBot() ? 1u : 0u);
+            PlayerGrid.Add({player->getID(), player->getVirtualWorld(), flags, pos.x, pos.y, pos.z});
+        }
+        PlayerGrid.Build();
+        PlayerGridStale = false;
+    }
+    return PlayerGrid;
+}
+
+static const SpatialGrid& CurrentVehicleGrid() {
+    if (VehicleGridStale && VehiclePool) {
+        VehicleGrid.Clear();
+        for (IVehicle* vehicle : *VehiclePool) {
+            Vector3 pos = vehicle->getPosition();
+            VehicleGrid.Add({vehicle->getID(), vehicle->getVirtualWorld(), static_cast<uint32_t>(vehicle->getModel()), pos.x, pos.y, pos.z});
+        }
+        VehicleGrid.Build();
+        VehicleGridStale = false;
+    }
+    return VehicleGrid;
+}
+
+static bool ValidSphere(float x, float y, float z, float radius) {
+    return std::isfinite(x) && std::isfinite(y) && std::isfinite(z) && std::isfinite(radius) && radius >= 0.0f;
+}
+
+static int SamplePlayersInRange(float x, float y, float z, float radius, int world, int state, int exceptid,
+                                bool includeNPCs, int32_t* out, int k) {
+    if (!ValidSphere(x, y, z, radius) || !PlayerPool) return 0;
+    const SpatialGrid& grid = CurrentPlayerGrid();
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    Reservoir reservoir(Randomix::GetRNG(), out, k);
+    grid.Query(x, y, z, radius, [&](const GridEntity& e) {
+        if (e.id == exceptid || (!includeNPCs && (e.flags & 1u))) return;
+        if (world != -1 && e.world != world) return;
+        if (state != -1 && static_cast<int>(e.flags >> 1) != state) return;
+        if (!PlayerPool->get(e.id)) return;
+        reservoir.Offer(e.id);
+    });
+    return reservoir.Finish();
+}
+
+static int SampleVehiclesInRange(float x, float y, float z, float radius, int world, int model, int32_t* out, int k) {
+    if (!ValidSphere(x, y, z, radius) || !VehiclePool) return 0;
+    const SpatialGrid& grid = CurrentVehicleGrid();
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    Reservoir reservoir(Randomix::GetRNG(), out, k);
+    grid.Query(x, y, z, radius, [&](const GridEntity& e) {
+        if (world != -1 && e.world != world) return;
+        if (model != -1 && static_cast<int>(e.flags) != model) return;
+        if (!VehiclePool->get(e.id)) return;
+        reservoir.Offer(e.id);
+    });
+    return reservoir.Finish();
+}
+
+SCRIPT_API(RandPlayerInRange, int(float x, float y, float z, float radius, int world, int state, int exceptid, bool includeNPCs)) {
+    int32_t id;
+    return SamplePlayersInRange(x, y, z, radius, world, state, exceptid, includeNPCs, &id, 1) ? id : RANDIX_INVALID_ID;
+}
+
+SCRIPT_API(RandPlayersInRange, int(float x, float y, float z, float radius, cell destAddr, int maxCount, int world, int state, int exceptid, bool includeNPCs)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest || maxCount <= 0) return 0;
+    
+    return SamplePlayersInRange(x, y, z, radius, world, state, exceptid, includeNPCs, dest, maxCount);
+}
+
+SCRIPT_API(RandVehicleInRange, int(float x, float y, float z, float radius, int world, int model)) {
+    int32_t id;
+    return SampleVehiclesInRange(x, y, z, radius, world, model, &id, 1) ? id : RANDIX_INVALID_ID;
+}
+
+SCRIPT_API(RandVehiclesInRange, int(float x, float y, float z, float radius, cell destAddr, int maxCount, int world, int model)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest || maxCount <= 0) return 0;
+    
+    return SampleVehiclesInRange(x, y, z, radius, world, model, dest, maxCount);
+}
+
+// Spawn sets
+// Enemies are other spawned players in the picker's virtual world whose team
+// differs (NO_TEAM counts as an enemy of everyone). Proximity uses the same
+// per-tick player grid as the range queries.
+
+static constexpr int RANDIX_NO_TEAM = 255;
+
+static bool IsSpawnedState(uint32_t state) {
+    PlayerState s = static_cast<PlayerState>(state);
+    return s != PlayerState_None && s != PlayerState_Wasted && s != PlayerState_Spectating;
+}
+
+SCRIPT_API(RandSpawnCreate, int()) {
+    return ImplRandSpawnCreate();
+}
+
+SCRIPT_API(RandSpawnAdd, int(int handle, float x, float y, float z, float angle, int team)) {
+    return ImplRandSpawnAdd(handle, x, y, z, angle, team);
+}
+
+SCRIPT_API(RandSpawnPick, int(int handle, int playerid, float minEnemyDist)) {
+    SpawnSet* set = SpawnSetPool().Get(handle);
+    if (!set || !PlayerPool || !std::isfinite(minEnemyDist)) return -1;
+    
+    IPlayer* picker = PlayerPool->get(playerid);
+    if (!picker) return -1;
+    
+    int team = picker->getTeam();
+    int world = picker->getVirtualWorld();
+    if (minEnemyDist <= 0.0f) {
+        return set->Pick(team, [](const SpawnPoint&) { return false; });
+    }
+    
+    const SpatialGrid& grid = CurrentPlayerGrid();
+    auto isEnemy = [&](const GridEntity& e) {
+        if (e.id == playerid || e.world != world || !IsSpawnedState(e.flags >> 1)) return false;
+        // The snapshot may predate a disconnect in this tick
+        IPlayer* other = PlayerPool->get(e.id);
+        return other != nullptr && (team == RANDIX_NO_TEAM || other->getTeam() != team);
+    };
+    return set->Pick(team, [&](const SpawnPoint& point) {
+        return grid.Any(point.x, point.y, point.z, minEnemyDist, isEnemy);
+    });
+}
+
+SCRIPT_API(RandSpawnGet, bool(int handle, int index, cell outX, cell outY, cell outZ, cell outAngle)) {
+    cell* xAddr = GetArrayPtr(GetAMX(), outX);
+    cell* yAddr = GetArrayPtr(GetAMX(), outY);
+    cell* zAddr = GetArrayPtr(GetAMX(), outZ);
+    cell* angleAddr = GetArrayPtr(GetAMX(), outAngle);
+    if (!xAddr || !yAddr || !zAddr || !angleAddr) return false;
+    
+    float x, y, z, angle;
+    if (!ImplRandSpawnGet(handle, index, x, y, z, angle)) return false;
+    
+    *reinterpret_cast<float*>(xAddr) = x;
+    *reinterpret_cast<float*>(yAddr) = y;
+    *reinterpret_cast<float*>(zAddr) = z;
+    *reinterpret_cast<float*>(angleAddr) = angle;
+    return true;
+}
+
+SCRIPT_API(RandSpawnCount, int(int handle)) {
+    return ImplRandSpawnCount(handle);
+}
+
+SCRIPT_API(RandSpawnDestroy, bool(int handle)) {
+    return ImplRandSpawnDestroy(handle);
+}
+
 // 2D geometry
 
 SCRIPT_API(RandPointInCircle, bool(float centerX, float centerY, float radius, cell outX, cell outY)) {
@@ -307,9 +1166,184 @@ SCRIPT_API(RandPointInPolygon, bool(cell verticesAddr, int vertexCount, cell out
     return true;
 }
 
+SCRIPT_API(RandPoissonDisk, int(float minX, float minY, float maxX, float maxY, float minDist, cell outXAddr, cell outYAddr, int maxPoints, int seed)) {
+    cell* outX = GetArrayPtr(GetAMX(), outXAddr);
+    cell* outY = GetArrayPtr(GetAMX(), outYAddr);
+    if (!outX || !outY) return 0;
+    
+    return ImplRandPoissonDisk(minX, minY, maxX, maxY, minDist, reinterpret_cast<float*>(outX),
+        reinterpret_cast<float*>(outY), maxPoints, static_cast<uint32_t>(seed));
+}
+
+// Async jobs
+
+SCRIPT_API(RandShuffleAsync, int(cell arrayAddr, int count, int seed)) {
+    cell* array = GetArrayPtr(GetAMX(), arrayAddr);
+    if (!array) return 0;
+    
+    return ImplRandShuffleAsync(GetAMX(), array, count, static_cast<uint32_t>(seed));
+}
+
+SCRIPT_API(RandPoissonDiskAsync, int(float minX, float minY, float maxX, float maxY, float minDist, int maxPoints, int seed)) {
+    return ImplRandPoissonDiskAsync(GetAMX(), minX, minY, maxX, maxY, minDist, maxPoints, static_cast<uint32_t>(seed));
+}
+
+SCRIPT_API(RandJobFetch, int(int job, cell destAddr, int maxCount, int offset)) {
+    cell* dest = GetArrayPtr(GetAMX(), destAddr);
+    if (!dest) return -1;
+    
+    return ImplRandJobFetch(job, dest, maxCount, offset);
+}
+
+SCRIPT_API(RandJobFetchPoints, int(int job, cell outXAddr, cell outYAddr, int maxCount)) {
+    cell* outX = GetArrayPtr(GetAMX(), outXAddr);
+    cell* outY = GetArrayPtr(GetAMX(), outYAddr);
+    if (!outX || !outY) return -1;
+    
+    return ImplRandJobFetchPoints(job, reinterpret_cast<float*>(outX), reinterpret_cast<float*>(outY), maxCount);
+}
+
+SCRIPT_API(RandJobDone, bool(int job)) {
+    return ImplRandJobDone(job);
+}
+
+SCRIPT_API(RandJobCancel, bool(int job)) {
+    return ImplRandJobCancel(job);
+}
+
+// Random events
+
+SCRIPT_API(RandEventExponential, int(cell callbackAddr, float meanMs, int arg, int maxFires)) {
+    cell* callback = GetArrayPtr(GetAMX(), callbackAddr);
+    if (!callback) return 0;
+    
+    char nameBuf[32];
+    GetString(callback, nameBuf, sizeof(nameBuf));
+    return ImplRandEventExponential(GetAMX(), nameBuf, meanMs, arg, maxFires);
+}
+
+SCRIPT_API(RandEventUniform, int(cell callbackAddr, int minMs, int maxMs, int arg, int maxFires)) {
+    cell* callback = GetArrayPtr(GetAMX(), callbackAddr);
+    if (!callback) return 0;
+    
+    char nameBuf[32];
+    GetString(callback, nameBuf, sizeof(nameBuf));
+    return ImplRandEventUniform(GetAMX(), nameBuf, minMs, maxMs, arg, maxFires);
+}
+
+SCRIPT_API(RandEventCustom, int(cell callbackAddr, cell delaysAddr, cell weightsAddr, int count, int arg, int maxFires)) {
+    cell* callback = GetArrayPtr(GetAMX(), callbackAddr);
+    cell* delays = GetArrayPtr(GetAMX(), delaysAddr);
+    cell* weights = GetArrayPtr(GetAMX(), weightsAddr);
+    if (!callback || !delays || !weights) return 0;
+    
+    char nameBuf[32];
+    GetString(callback, nameBuf, sizeof(nameBuf));
+    return ImplRandEventCustom(GetAMX(), nameBuf, delays, weights, count, arg, maxFires);
+}
+
+SCRIPT_API(RandEventRemaining, int(int event)) {
+    return ImplRandEventRemaining(event);
+}
+
+SCRIPT_API(RandEventStop, bool(int event)) {
+    return ImplRandEventStop(event);
+}
+
+// Raw natives - variadic natives and natives with trailing optional
+// arguments need the parameter count, so they are registered with
+// amx_Register instead of SCRIPT_API
+
+// RandShuffleMulti(count, ...) - every variadic argument is an array address
+static cell AMX_NATIVE_CALL n_RandShuffleMulti(AMX* amx, cell* params) {
+    int arrayCount = static_cast<int>(params[0] / sizeof(cell)) - 1;
+    if (arrayCount <= 0 || arrayCount > 16) return 0;
+    
+    int* arrays[16];
+    for (int i = 0; i < arrayCount; i++) {
+        cell* array = GetArrayPtr(amx, params[2 + i]);
+        if (!array) return 0;
+        arrays[i] = reinterpret_cast<int*>(array);
+    }
+    return ImplRandShuffleMulti(arrays, arrayCount, static_cast<int>(params[1])) ? 1 : 0;
+}
+
+// stride and offset are optional; scripts built against an include without
+// them pass fewer arguments, so they are read only when present
+static inline bool GetStride(cell* params, int first, int& stride, int& offset) {
+    int argc = static_cast<int>(params[0] / sizeof(cell));
+    stride = (argc >= first) ? static_cast<int>(params[first]) : 1;
+    offset = (argc >= first + 1) ? static_cast<int>(params[first + 1]) : 0;
+    return stride > 0 && offset >= 0;
+}
+
+// RandWeighted(weights[], count, stride = 1, offset = 0)
+static cell AMX_NATIVE_CALL n_RandWeighted(AMX* amx, cell* params) {
+    int count = static_cast<int>(params[2]);
+    int stride, offset;
+    if (count <= 0 || !GetStride(params, 3, stride, offset)) return 0;
+    
+    cell* weights = GetArrayPtr(amx, params[1]);
+    if (!weights) return 0;
+    
+    return ImplRandWeighted(reinterpret_cast<int*>(weights + offset), count, stride);
+}
+
+// RandShuffle(array[], count, stride = 1, offset = 0)
+static cell AMX_NATIVE_CALL n_RandShuffle(AMX* amx, cell* params) {
+    int count = static_cast<int>(params[2]);
+    int stride, offset;
+    if (!GetStride(params, 3, stride, offset)) return 0;
+    
+    cell* array = GetArrayPtr(amx, params[1]);
+    if (!array) return 0;
+    
+    return ImplRandShuffle(reinterpret_cast<int*>(array + offset), count, stride) ? 1 : 0;
+}
+
+// RandPick(array[], count, stride = 1, offset = 0)
+static cell AMX_NATIVE_CALL n_RandPick(AMX* amx, cell* params) {
+    int count = static_cast<int>(params[2]);
+    int stride, offset;
+    if (count <= 0 || !GetStride(params, 3, stride, offset)) return 0;
+    
+    cell* array = GetArrayPtr(amx, params[1]);
+    if (!array) return 0;
+    
+    return ImplRandPick(reinterpret_cast<int*>(array + offset), count, stride);
+}
+
+static const AMX_NATIVE_INFO RawNatives[] = {
+    {"RandShuffleMulti", n_RandShuffleMulti},
+    {"RandWeighted", n_RandWeighted},
+    {"RandShuffle", n_RandShuffle},
+    {"RandPick", n_RandPick},
+    {nullptr, nullptr}
+};
+
+// Run queued script callbacks (deferred work completions) on the server thread
+static void DispatchCallbacks() {
+    std::vector<ScriptCallback> callbacks;
+    PendingCallbacks().Drain(callbacks);
+    
+    for (const auto& cb : callbacks) {
+        AMX* amx = static_cast<AMX*>(cb.owner);
+        int index;
+        if (amx_FindPublic(amx, cb.name.c_str(), &index) == AMX_ERR_NONE) {
+            for (auto it = cb.args.rbegin(); it != cb.args.rend(); ++it) {
+                amx_Push(amx, static_cast<cell>(*it));
+            }
+            cell retval;
+            amx_Exec(amx, &retval, index);
+        }
+        if (cb.after) cb.after();
+    }
+}
+
 // Component class
 
-class RandomixComponent final : public IComponent, public PawnEventHandler {
+class RandomixComponent final : public IComponent, public PawnEventHandler, public CoreEventHandler,
+                                public PlayerConnectEventHandler, public PoolEventHandler<IVehicle> {
 private:
     ICore* core_ = nullptr;
     IPawnComponent* pawn_ = nullptr;
@@ -318,9 +1352,17 @@ public:
     PROVIDE_UID(0x4D52616E646F6D69);
     
     ~RandomixComponent() {
+        ShutdownWorkers();
         if (pawn_) {
             pawn_->getEventDispatcher().removeEventHandler(this);
         }
+        if (core_) {
+            core_->getEventDispatcher().removeEventHandler(this);
+            core_->getPlayers().getPlayerConnectDispatcher().removeEventHandler(this);
+        }
+        if (VehiclePool) {
+            VehiclePool->getPoolEventDispatcher().removeEventHandler(this);
+        }
     }
     
     StringView componentName() const override { return "Randomix"; }
@@ -341,6 +1383,9 @@ public:
         core_->printLn("");
         
         setAmxLookups(core_);
+        core_->getEventDispatcher().addEventHandler(this);
+        PlayerPool = &core_->getPlayers();
+        PlayerPool->getPlayerConnectDispatcher().addEventHandler(this);
     }
     
     void onInit(IComponentList* components) override {
@@ -350,16 +1395,47 @@ public:
             setAmxLookups(components);
             pawn_->getEventDispatcher().addEventHandler(this);
         }
+        VehiclePool = components->queryComponent<IVehiclesComponent>();
+        if (VehiclePool) {
+            VehiclePool->getPoolEventDispatcher().addEventHandler(this);
+        }
+        ObjectPool = components->queryComponent<IObjectsComponent>();
     }
     
     void onAmxLoad(IPawnScript& script) override {
         pawn_natives::AmxLoad(script.GetAMX());
+        amx_Register(script.GetAMX(), RawNatives, -1);
+    }
+    
+    void onAmxUnload(IPawnScript& script) override {
+        ReleaseScriptJobs(script.GetAMX());
     }
     
-    void onAmxUnload(IPawnScript& script) override {}
+    void onTick(Microseconds elapsed, TimePoint now) override {
+        PlayerGridStale = true;
+        VehicleGridStale = true;
+        ProcessSlicedShuffles();
+        ProcessRandEvents();
+        DispatchCallbacks();
+    }
     void onReady() override {}
     
+    // A grid built earlier in the tick must not return entities that are gone
+    void onPlayerDisconnect(IPlayer& player, PeerDisconnectReason reason) override {
+        PlayerGridStale = true;
+    }
+    
+    void onPoolEntryDestroyed(IVehicle& vehicle) override {
+        VehicleGridStale = true;
+    }
+    
     void onFree(IComponent* component) override {
+        if (component == VehiclePool) {
+            VehiclePool->getPoolEventDispatcher().removeEventHandler(this);
+            VehiclePool = nullptr;
+            VehicleGrid.Clear();
+        }
+        if (component == ObjectPool) ObjectPool = nullptr;
         if (component == pawn_) {
             pawn_->getEventDispatcher().removeEventHandler(this);
             pawn_ = nullptr;
@@ -16,7 +16,7 @@ typedef void (*logprintf_t)(const char* format, ...);
 logprintf_t logprintf;
 
 PLUGIN_EXPORT unsigned int PLUGIN_CALL Supports() {
-    return SUPPORTS_VERSION | SUPPORTS_AMX_NATIVES;
+    return SUPPORTS_VERSION | SUPPORTS_AMX_NATIVES | SUPPORTS_PROCESS_TICK;
 }
 
 PLUGIN_EXPORT bool PLUGIN_CALL Load(void** ppData) {
@@ -38,6 +38,7 @@ PLUGIN_EXPORT bool PLUGIN_CALL Load(void** ppData) {
 }
 
 PLUGIN_EXPORT void PLUGIN_CALL Unload() {
+    ShutdownWorkers();
     logprintf("");
     logprintf("  Randomix v2.0.1 Unloaded");
     logprintf("");
@@ -49,6 +50,55 @@ static inline cell* GetAddr(AMX* amx, cell address) {
     return phys_addr;
 }
 
+// Copy an unpacked Pawn string into a char buffer (always terminated)
+static inline int GetString(cell* src, char* buf, int bufSize) {
+    int i;
+    for (i = 0; i < bufSize - 1 && src[i] != 0; i++) {
+        buf[i] = static_cast<char>(src[i]);
+    }
+    buf[i] = '\0';
+    return i;
+}
+
+// Resolve row `index` of a 2D Pawn array via its indirection table
+static inline cell* GetArrayRow(cell* base, int index) {
+    return reinterpret_cast<cell*>(reinterpret_cast<char*>(base + index) + base[index]);
+}
+
+// Row count of a 2D Pawn array: row 0's data starts right after the
+// indirection table, so its offset is the table size in bytes
+static inline int GetArrayRowCount(cell* base) {
+    return static_cast<int>(base[0] / static_cast<cell>(sizeof(cell)));
+}
+
+// Run queued script callbacks (deferred work completions) on the server thread
+static void DispatchCallbacks() {
+    std::vector<ScriptCallback> callbacks;
+    PendingCallbacks().Drain(callbacks);
+    
+    for (const auto& cb : callbacks) {
+        AMX* amx = static_cast<AMX*>(cb.owner);
+        int index;
+        if (amx_FindPublic(amx, cb.name.c_str(), &index) == AMX_ERR_NONE) {
+            for (auto it = cb.args.rbegin(); it != cb.args.rend(); ++it) {
+                amx_Push(amx, static_cast<cell>(*it));
+            }
+            cell retval;
+            amx_Exec(amx, &retval, index);
+        }
+        if (cb.after) cb.after();
+    }
+}
+
+// Optional trailing stride/offset parameters starting at params[first];
+// scripts compiled against older includes do not pass them
+static inline bool GetStride(cell* params, int first, int& stride, int& offset) {
+    int argc = static_cast<int>(params[0] / sizeof(cell));
+    stride = (argc >= first) ? static_cast<int>(params[first]) : 1;
+    offset = (argc >= first + 1) ? static_cast<int>(params[first + 1]) : 0;
+    return stride > 0 && offset >= 0;
+}
+
 // Core random functions
 
 static cell AMX_NATIVE_CALL n_RandRange(AMX* amx, cell* params) {
@@ -84,6 +134,9 @@ static cell AMX_NATIVE_CALL n_RandWeighted(AMX* amx, cell* params) {
     int count = static_cast<int>(params[2]);
     if (count <= 0) return 0;
     
+    int stride, offset;
+    if (!GetStride(params, 3, stride, offset)) return 0;
+    
     cell* weights = GetAddr(amx, params[1]);
     if (!weights) return 0;
     
@@ -91,7 +144,7 @@ static cell AMX_NATIVE_CALL n_RandWeighted(AMX* amx, cell* params) {
     static thread_local int intWeights[65536];
     int actualCount = (count > 65536) ? 65536 : count;
     for (int i = 0; i < actualCount; i++) {
-        intWeights[i] = static_cast<int>(weights[i]);
+        intWeights[i] = static_cast<int>(weights[offset + static_cast<size_t>(i) * stride]);
     }
     
     return static_cast<cell>(ImplRandWeighted(intWeights, actualCount));
@@ -101,10 +154,13 @@ static cell AMX_NATIVE_CALL n_RandShuffle(AMX* amx, cell* params) {
     int count = static_cast<int>(params[2]);
     if (count <= 1) return 1;
     
+    int stride, offset;
+    if (!GetStride(params, 3, stride, offset)) return 0;
+    
     cell* array = GetAddr(amx, params[1]);
     if (!array) return 0;
     
-    return ImplRandShuffle(reinterpret_cast<int*>(array), count) ? 1 : 0;
+    return ImplRandShuffle(reinterpret_cast<int*>(array + offset), count, stride) ? 1 : 0;
 }
 
 static cell AMX_NATIVE_CALL n_RandShuffleRange(AMX* amx, cell* params) {
@@ -117,6 +173,60 @@ static cell AMX_NATIVE_CALL n_RandShuffleRange(AMX* amx, cell* params) {
     return ImplRandShuffleRange(reinterpret_cast<int*>(array), start, end) ? 1 : 0;
 }
 
+// RandShuffleMulti(count, ...) - every variadic argument is an array address
+static cell AMX_NATIVE_CALL n_RandShuffleMulti(AMX* amx, cell* params) {
+    int arrayCount = static_cast<int>(params[0] / sizeof(cell)) - 1;
+    if (arrayCount <= 0 || arrayCount > 16) return 0;
+    
+    int* arrays[16];
+    for (int i = 0; i < arrayCount; i++) {
+        cell* array = GetAddr(amx, params[2 + i]);
+        if (!array) return 0;
+        arrays[i] = reinterpret_cast<int*>(array);
+    }
+    return ImplRandShuffleMulti(arrays, arrayCount, static_cast<int>(params[1])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandShuffleThreads(AMX* amx, cell* params) {
+    return ImplRandShuffleThreads(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+// Only global/static arrays (below the heap) outlive the calling function
+static cell AMX_NATIVE_CALL n_RandShuffleBegin(AMX* amx, cell* params) {
+    // The whole array must lie below the heap, not just its first cell
+    int64_t bytes = static_cast<int64_t>(params[2]) * static_cast<int64_t>(sizeof(cell));
+    if (params[1] < 0 || params[2] <= 0 || params[1] + bytes > amx->hlw) return 0;
+    
+    cell* array = GetAddr(amx, params[1]);
+    if (!array) return 0;
+    
+    return static_cast<cell>(ImplRandShuffleBegin(amx, array, static_cast<int>(params[2]), static_cast<int>(params[3])));
+}
+
+static cell AMX_NATIVE_CALL n_RandShuffleProgress(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandShuffleProgress(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandShuffleCancel(AMX* amx, cell* params) {
+    return ImplRandShuffleCancel(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandShuffleRows(AMX* amx, cell* params) {
+    int rowCount = static_cast<int>(params[2]);
+    if (rowCount <= 1) return 1;
+    if (rowCount > 1000000) return 0;
+    
+    cell* base = GetAddr(amx, params[1]);
+    if (!base || rowCount > GetArrayRowCount(base)) return 0;
+    if (params[3] > GetArrayRow(base, 1) - GetArrayRow(base, 0)) return 0;
+    
+    std::vector<int*> rows(static_cast<size_t>(rowCount));
+    for (int i = 0; i < rowCount; i++) {
+        rows[i] = reinterpret_cast<int*>(GetArrayRow(base, i));
+    }
+    return ImplRandShuffleRows(rows.data(), rowCount, static_cast<int>(params[3])) ? 1 : 0;
+}
+
 static cell AMX_NATIVE_CALL n_RandGaussian(AMX* amx, cell* params) {
     float mean = amx_ctof(params[1]);
     float stddev = amx_ctof(params[2]);
@@ -133,13 +243,16 @@ static cell AMX_NATIVE_CALL n_RandPick(AMX* amx, cell* params) {
     int count = static_cast<int>(params[2]);
     if (count <= 0) return 0;
     
+    int stride, offset;
+    if (!GetStride(params, 3, stride, offset)) return 0;
+    
     cell* array = GetAddr(amx, params[1]);
     if (!array) return 0;
     
     static thread_local int intArray[65536];
     int actualCount = (count > 65536) ? 65536 : count;
     for (int i = 0; i < actualCount; i++) {
-        intArray[i] = static_cast<int>(array[i]);
+        intArray[i] = static_cast<int>(array[offset + static_cast<size_t>(i) * stride]);
     }
     
     return static_cast<cell>(ImplRandPick(intArray, actualCount));
@@ -175,6 +288,30 @@ static cell AMX_NATIVE_CALL n_RandFormat(AMX* amx, cell* params) {
     return 1;
 }
 
+static cell AMX_NATIVE_CALL n_RandFormatChecked(AMX* amx, cell* params) {
+    int destSize = static_cast<int>(params[3]);
+    if (destSize <= 0) return 0;
+    
+    cell* dest = GetAddr(amx, params[1]);
+    cell* pattern = GetAddr(amx, params[2]);
+    if (!dest || !pattern) return 0;
+    
+    if (destSize > 65536) destSize = 65536;
+    
+    char patternBuf[256];
+    GetString(pattern, patternBuf, sizeof(patternBuf));
+    
+    static thread_local char destBuf[65536];
+    if (!ImplRandFormat(destBuf, patternBuf, destSize, true)) return 0;
+    
+    int i;
+    for (i = 0; destBuf[i] != '\0' && i < destSize - 1; i++) {
+        dest[i] = static_cast<cell>(destBuf[i]);
+    }
+    dest[i] = 0;
+    return 1;
+}
+
 // Cryptographic functions
 
 static cell AMX_NATIVE_CALL n_RandBytes(AMX* amx, cell* params) {
@@ -209,6 +346,554 @@ static cell AMX_NATIVE_CALL n_RandUUID(AMX* amx, cell* params) {
     return 1;
 }
 
+static cell AMX_NATIVE_CALL n_RandUUIDv7(AMX* amx, cell* params) {
+    cell* out = GetAddr(amx, params[1]);
+    if (!out) return 0;
+    
+    char uuidBuf[40];
+    if (!ImplRandUUIDv7(uuidBuf)) return 0;
+    
+    for (int i = 0; uuidBuf[i] != '\0'; i++) {
+        out[i] = static_cast<cell>(uuidBuf[i]);
+    }
+    out[36] = 0;
+    return 1;
+}
+
+static cell AMX_NATIVE_CALL n_RandUUIDBulk(AMX* amx, cell* params) {
+    int count = static_cast<int>(params[2]);
+    int version = static_cast<int>(params[3]);
+    if (count <= 0) return 0;
+    
+    cell* dest = GetAddr(amx, params[1]);
+    if (!dest || count > GetArrayRowCount(dest)) return 0;
+    
+    return static_cast<cell>(ImplRandUUIDBulk(count, version, [dest](int index, const char* uuid) {
+        cell* row = GetArrayRow(dest, index);
+        for (int i = 0; i < 36; i++) {
+            row[i] = static_cast<cell>(uuid[i]);
+        }
+        row[36] = 0;
+    }));
+}
+
+static cell AMX_NATIVE_CALL n_RandTokenBase64(AMX* amx, cell* params) {
+    cell* dest = GetAddr(amx, params[1]);
+    if (!dest) return 0;
+    
+    int bytes = static_cast<int>(params[2]);
+    int destSize = static_cast<int>(params[3]);
+    int filter = static_cast<int>(params[4]);
+    return static_cast<cell>(ImplRandToken(dest, destSize, bytes, TokenEncoding::Base64Url, filter));
+}
+
+static cell AMX_NATIVE_CALL n_RandTokenBase32(AMX* amx, cell* params) {
+    cell* dest = GetAddr(amx, params[1]);
+    if (!dest) return 0;
+    
+    int bytes = static_cast<int>(params[2]);
+    int destSize = static_cast<int>(params[3]);
+    int filter = static_cast<int>(params[4]);
+    return static_cast<cell>(ImplRandToken(dest, destSize, bytes, TokenEncoding::Base32, filter));
+}
+
+static cell AMX_NATIVE_CALL n_RandTokenCrockford(AMX* amx, cell* params) {
+    cell* dest = GetAddr(amx, params[1]);
+    if (!dest) return 0;
+    
+    int bytes = static_cast<int>(params[2]);
+    int destSize = static_cast<int>(params[3]);
+    int filter = static_cast<int>(params[4]);
+    return static_cast<cell>(ImplRandToken(dest, destSize, bytes, TokenEncoding::Crockford, filter));
+}
+
+static cell AMX_NATIVE_CALL n_RandCodeVerify(AMX* amx, cell* params) {
+    cell* code = GetAddr(amx, params[1]);
+    if (!code) return 0;
+    
+    char codeBuf[256];
+    GetString(code, codeBuf, sizeof(codeBuf));
+    return ImplRandCodeVerify(codeBuf, static_cast<int>(params[2])) ? 1 : 0;
+}
+
+// Blocklist filters
+
+static cell AMX_NATIVE_CALL n_RandFilterCreate(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandFilterCreate(params[1] != 0));
+}
+
+static cell AMX_NATIVE_CALL n_RandFilterAddWord(AMX* amx, cell* params) {
+    cell* word = GetAddr(amx, params[2]);
+    if (!word) return 0;
+    
+    char wordBuf[256];
+    GetString(word, wordBuf, sizeof(wordBuf));
+    return ImplRandFilterAddWord(static_cast<int>(params[1]), wordBuf) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandFilterLoad(AMX* amx, cell* params) {
+    cell* filename = GetAddr(amx, params[1]);
+    if (!filename) return 0;
+    
+    char nameBuf[256];
+    GetString(filename, nameBuf, sizeof(nameBuf));
+    return static_cast<cell>(ImplRandFilterLoad(nameBuf, params[2] != 0));
+}
+
+static cell AMX_NATIVE_CALL n_RandFilterCheck(AMX* amx, cell* params) {
+    cell* text = GetAddr(amx, params[2]);
+    if (!text) return 0;
+    
+    char textBuf[1024];
+    GetString(text, textBuf, sizeof(textBuf));
+    return ImplRandFilterCheck(static_cast<int>(params[1]), textBuf) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandFilterWordCount(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandFilterWordCount(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandFilterDestroy(AMX* amx, cell* params) {
+    return ImplRandFilterDestroy(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandFormatFiltered(AMX* amx, cell* params) {
+    int destSize = static_cast<int>(params[4]);
+    if (destSize <= 0) return 0;
+    
+    cell* dest = GetAddr(amx, params[2]);
+    cell* pattern = GetAddr(amx, params[3]);
+    if (!dest || !pattern) return 0;
+    
+    char patternBuf[256];
+    GetString(pattern, patternBuf, sizeof(patternBuf));
+    
+    char destBuf[256];
+    if (destSize > static_cast<int>(sizeof(destBuf))) destSize = sizeof(destBuf);
+    if (!ImplRandFormatFiltered(static_cast<int>(params[1]), destBuf, patternBuf, destSize)) return 0;
+    
+    int i;
+    for (i = 0; destBuf[i] != '\0'; i++) {
+        dest[i] = static_cast<cell>(destBuf[i]);
+    }
+    dest[i] = 0;
+    return 1;
+}
+
+// Reverse regex
+
+static cell AMX_NATIVE_CALL n_RandRegexCompile(AMX* amx, cell* params) {
+    cell* pattern = GetAddr(amx, params[1]);
+    if (!pattern) return 0;
+    
+    char patternBuf[512];
+    GetString(pattern, patternBuf, sizeof(patternBuf));
+    return static_cast<cell>(ImplRandRegexCompile(patternBuf));
+}
+
+static cell AMX_NATIVE_CALL n_RandRegex(AMX* amx, cell* params) {
+    cell* dest = GetAddr(amx, params[2]);
+    if (!dest) return -1;
+    
+    return static_cast<cell>(ImplRandRegex(static_cast<int>(params[1]), dest, static_cast<int>(params[3])));
+}
+
+static cell AMX_NATIVE_CALL n_RandRegexMaxLength(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandRegexMaxLength(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandRegexDestroy(AMX* amx, cell* params) {
+    return ImplRandRegexDestroy(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+// Token registries
+
+static cell AMX_NATIVE_CALL n_RandRegistryCreate(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandRegistryCreate(static_cast<int>(params[1]), params[2] != 0));
+}
+
+static cell AMX_NATIVE_CALL n_RandRegistryAdd(AMX* amx, cell* params) {
+    cell* token = GetAddr(amx, params[2]);
+    if (!token) return -1;
+    
+    char tokenBuf[256];
+    GetString(token, tokenBuf, sizeof(tokenBuf));
+    return static_cast<cell>(ImplRandRegistryAdd(static_cast<int>(params[1]), tokenBuf));
+}
+
+static cell AMX_NATIVE_CALL n_RandRegistryContains(AMX* amx, cell* params) {
+    cell* token = GetAddr(amx, params[2]);
+    if (!token) return 0;
+    
+    char tokenBuf[256];
+    GetString(token, tokenBuf, sizeof(tokenBuf));
+    return ImplRandRegistryContains(static_cast<int>(params[1]), tokenBuf) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandRegistryRemove(AMX* amx, cell* params) {
+    cell* token = GetAddr(amx, params[2]);
+    if (!token) return 0;
+    
+    char tokenBuf[256];
+    GetString(token, tokenBuf, sizeof(tokenBuf));
+    return ImplRandRegistryRemove(static_cast<int>(params[1]), tokenBuf) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandRegistryCount(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandRegistryCount(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandRegistrySave(AMX* amx, cell* params) {
+    cell* filename = GetAddr(amx, params[2]);
+    if (!filename) return 0;
+    
+    char nameBuf[256];
+    GetString(filename, nameBuf, sizeof(nameBuf));
+    return ImplRandRegistrySave(static_cast<int>(params[1]), nameBuf) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandRegistryLoad(AMX* amx, cell* params) {
+    cell* filename = GetAddr(amx, params[1]);
+    if (!filename) return 0;
+    
+    char nameBuf[256];
+    GetString(filename, nameBuf, sizeof(nameBuf));
+    return static_cast<cell>(ImplRandRegistryLoad(nameBuf));
+}
+
+static cell AMX_NATIVE_CALL n_RandRegistryDestroy(AMX* amx, cell* params) {
+    return ImplRandRegistryDestroy(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandFormatUnique(AMX* amx, cell* params) {
+    int destSize = static_cast<int>(params[5]);
+    if (destSize <= 0) return 0;
+    
+    cell* dest = GetAddr(amx, params[2]);
+    cell* pattern = GetAddr(amx, params[3]);
+    if (!dest || !pattern) return 0;
+    
+    char patternBuf[256];
+    GetString(pattern, patternBuf, sizeof(patternBuf));
+    
+    char destBuf[256];
+    if (destSize > static_cast<int>(sizeof(destBuf))) destSize = sizeof(destBuf);
+    if (!ImplRandFormatUnique(static_cast<int>(params[1]), destBuf, patternBuf, destSize, static_cast<int>(params[4]))) return 0;
+    
+    int i;
+    for (i = 0; destBuf[i] != '\0'; i++) {
+        dest[i] = static_cast<cell>(destBuf[i]);
+    }
+    dest[i] = 0;
+    return 1;
+}
+
+// Lazy permutations
+
+static cell AMX_NATIVE_CALL n_RandPermCreate(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandPermCreate(static_cast<int>(params[1]), static_cast<uint32_t>(params[2])));
+}
+
+static cell AMX_NATIVE_CALL n_RandPermAt(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandPermAt(static_cast<int>(params[1]), static_cast<int>(params[2])));
+}
+
+static cell AMX_NATIVE_CALL n_RandPermIndexOf(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandPermIndexOf(static_cast<int>(params[1]), static_cast<int>(params[2])));
+}
+
+static cell AMX_NATIVE_CALL n_RandPermSize(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandPermSize(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandPermDestroy(AMX* amx, cell* params) {
+    return ImplRandPermDestroy(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+// Unique codes
+
+static cell AMX_NATIVE_CALL n_RandUniqueCodeCreate(AMX* amx, cell* params) {
+    cell* pattern = GetAddr(amx, params[1]);
+    if (!pattern) return 0;
+    
+    char patternBuf[256];
+    GetString(pattern, patternBuf, sizeof(patternBuf));
+    return static_cast<cell>(ImplRandUniqueCodeCreate(patternBuf, static_cast<uint32_t>(params[2])));
+}
+
+static cell AMX_NATIVE_CALL n_RandUniqueCodeCreateKeyed(AMX* amx, cell* params) {
+    cell* pattern = GetAddr(amx, params[1]);
+    cell* secret = GetAddr(amx, params[2]);
+    if (!pattern || !secret) return 0;
+    
+    char patternBuf[256], secretBuf[256];
+    GetString(pattern, patternBuf, sizeof(patternBuf));
+    GetString(secret, secretBuf, sizeof(secretBuf));
+    int handle = ImplRandUniqueCodeCreateKeyed(patternBuf, secretBuf);
+    std::fill(secretBuf, secretBuf + sizeof(secretBuf), 0);
+    return static_cast<cell>(handle);
+}
+
+static cell AMX_NATIVE_CALL n_RandUniqueCode(AMX* amx, cell* params) {
+    cell* dest = GetAddr(amx, params[3]);
+    if (!dest) return 0;
+    
+    int handle = static_cast<int>(params[1]);
+    int counter = static_cast<int>(params[2]);
+    int destSize = static_cast<int>(params[4]);
+    return ImplRandUniqueCode(handle, counter, dest, destSize) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandUniqueCodeSpace(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandUniqueCodeSpace(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandUniqueCodeDestroy(AMX* amx, cell* params) {
+    return ImplRandUniqueCodeDestroy(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+// Markov names
+
+static cell AMX_NATIVE_CALL n_RandMarkovCreate(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandMarkovCreate(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandMarkovTrain(AMX* amx, cell* params) {
+    cell* name = GetAddr(amx, params[2]);
+    if (!name) return 0;
+    
+    char nameBuf[256];
+    GetString(name, nameBuf, sizeof(nameBuf));
+    return ImplRandMarkovTrain(static_cast<int>(params[1]), nameBuf) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandMarkovLoad(AMX* amx, cell* params) {
+    cell* filename = GetAddr(amx, params[1]);
+    if (!filename) return 0;
+    
+    char nameBuf[256];
+    GetString(filename, nameBuf, sizeof(nameBuf));
+    return static_cast<cell>(ImplRandMarkovLoad(nameBuf, static_cast<int>(params[2])));
+}
+
+static cell AMX_NATIVE_CALL n_RandMarkovName(AMX* amx, cell* params) {
+    cell* dest = GetAddr(amx, params[2]);
+    cell* prefix = GetAddr(amx, params[5]);
+    if (!dest || !prefix) return -1;
+    
+    char prefixBuf[64];
+    GetString(prefix, prefixBuf, sizeof(prefixBuf));
+    return static_cast<cell>(ImplRandMarkovName(static_cast<int>(params[1]), dest, static_cast<int>(params[7]),
+        static_cast<int>(params[3]), static_cast<int>(params[4]), prefixBuf, params[6] != 0));
+}
+
+static cell AMX_NATIVE_CALL n_RandMarkovNameCount(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandMarkovNameCount(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandMarkovDestroy(AMX* amx, cell* params) {
+    return ImplRandMarkovDestroy(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+// Passphrases
+
+static cell AMX_NATIVE_CALL n_RandPassphrase(AMX* amx, cell* params) {
+    cell* dest = GetAddr(amx, params[1]);
+    cell* separator = GetAddr(amx, params[3]);
+    cell* wordlist = GetAddr(amx, params[4]);
+    if (!dest || !separator || !wordlist) return -1;
+    
+    char sepBuf[16];
+    char listBuf[256];
+    GetString(separator, sepBuf, sizeof(sepBuf));
+    GetString(wordlist, listBuf, sizeof(listBuf));
+    return static_cast<cell>(ImplRandPassphrase(dest, static_cast<int>(params[5]), static_cast<int>(params[2]), sepBuf, listBuf));
+}
+
+static cell AMX_NATIVE_CALL n_RandPassphraseWordCount(AMX* amx, cell* params) {
+    cell* wordlist = GetAddr(amx, params[1]);
+    if (!wordlist) return 0;
+    
+    char listBuf[256];
+    GetString(wordlist, listBuf, sizeof(listBuf));
+    return static_cast<cell>(ImplRandPassphraseWordCount(listBuf));
+}
+
+// Decks
+
+static cell AMX_NATIVE_CALL n_RandDeckCreate(AMX* amx, cell* params) {
+    cell* values = GetAddr(amx, params[1]);
+    if (!values) return 0;
+    
+    return static_cast<cell>(ImplRandDeckCreate(values, static_cast<int>(params[2]), params[3] != 0));
+}
+
+static cell AMX_NATIVE_CALL n_RandDeckDraw(AMX* amx, cell* params) {
+    cell* valueAddr = GetAddr(amx, params[2]);
+    if (!valueAddr) return 0;
+    
+    int32_t value;
+    if (!ImplRandDeckDraw(static_cast<int>(params[1]), value)) return 0;
+    *valueAddr = static_cast<cell>(value);
+    return 1;
+}
+
+static cell AMX_NATIVE_CALL n_RandDeckReturn(AMX* amx, cell* params) {
+    return ImplRandDeckReturn(static_cast<int>(params[1]), static_cast<int32_t>(params[2])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandDeckReshuffle(AMX* amx, cell* params) {
+    return ImplRandDeckReshuffle(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandDeckRemaining(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandDeckRemaining(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandDeckSize(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandDeckSize(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandDeckDestroy(AMX* amx, cell* params) {
+    return ImplRandDeckDestroy(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+// Unique ranges
+
+static cell AMX_NATIVE_CALL n_RandUniqueRangeCreate(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandUniqueRangeCreate(static_cast<int>(params[1]), static_cast<int>(params[2])));
+}
+
+static cell AMX_NATIVE_CALL n_RandUniqueNext(AMX* amx, cell* params) {
+    cell* valueAddr = GetAddr(amx, params[2]);
+    if (!valueAddr) return 0;
+    
+    int32_t value;
+    if (!ImplRandUniqueNext(static_cast<int>(params[1]), value)) return 0;
+    *valueAddr = static_cast<cell>(value);
+    return 1;
+}
+
+static cell AMX_NATIVE_CALL n_RandUniqueRangeRemaining(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandUniqueRangeRemaining(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandUniqueRangeReset(AMX* amx, cell* params) {
+    return ImplRandUniqueRangeReset(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandUniqueRangeDestroy(AMX* amx, cell* params) {
+    return ImplRandUniqueRangeDestroy(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+// Exclusion-aware ranges
+
+static cell AMX_NATIVE_CALL n_RandRangeExcluding(AMX* amx, cell* params) {
+    cell* excluded = GetAddr(amx, params[3]);
+    int count = static_cast<int>(params[4]);
+    if (!excluded) count = 0;
+    
+    return static_cast<cell>(ImplRandRangeExcluding(static_cast<int>(params[1]), static_cast<int>(params[2]), excluded, count));
+}
+
+static cell AMX_NATIVE_CALL n_RandIntSetCreate(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandIntSetCreate(static_cast<int>(params[1]), static_cast<int>(params[2])));
+}
+
+static cell AMX_NATIVE_CALL n_RandIntSetExclude(AMX* amx, cell* params) {
+    return ImplRandIntSetExclude(static_cast<int>(params[1]), static_cast<int>(params[2]), static_cast<int>(params[3])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandIntSetInclude(AMX* amx, cell* params) {
+    return ImplRandIntSetInclude(static_cast<int>(params[1]), static_cast<int>(params[2]), static_cast<int>(params[3])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandIntSetContains(AMX* amx, cell* params) {
+    return ImplRandIntSetContains(static_cast<int>(params[1]), static_cast<int>(params[2])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandIntSetCount(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandIntSetCount(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandIntSetPick(AMX* amx, cell* params) {
+    cell* valueAddr = GetAddr(amx, params[2]);
+    if (!valueAddr) return 0;
+    
+    int32_t value;
+    if (!ImplRandIntSetPick(static_cast<int>(params[1]), value)) return 0;
+    *valueAddr = static_cast<cell>(value);
+    return 1;
+}
+
+static cell AMX_NATIVE_CALL n_RandIntSetDestroy(AMX* amx, cell* params) {
+    return ImplRandIntSetDestroy(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+// Loot tables
+
+static cell AMX_NATIVE_CALL n_RandLootLoad(AMX* amx, cell* params) {
+    cell* filename = GetAddr(amx, params[1]);
+    if (!filename) return 0;
+    
+    char nameBuf[256];
+    GetString(filename, nameBuf, sizeof(nameBuf));
+    return static_cast<cell>(ImplRandLootLoad(nameBuf));
+}
+
+static cell AMX_NATIVE_CALL n_RandLootTable(AMX* amx, cell* params) {
+    cell* name = GetAddr(amx, params[1]);
+    if (!name) return 0;
+    
+    char nameBuf[128];
+    GetString(name, nameBuf, sizeof(nameBuf));
+    return static_cast<cell>(ImplRandLootTable(nameBuf));
+}
+
+static cell AMX_NATIVE_CALL n_RandLootRoll(AMX* amx, cell* params) {
+    cell* dest = GetAddr(amx, params[2]);
+    if (!dest) return -1;
+    
+    return static_cast<cell>(ImplRandLootRoll(static_cast<int>(params[1]), dest, static_cast<int>(params[3])));
+}
+
+// LRU-biased selectors
+
+static cell AMX_NATIVE_CALL n_RandSelectorCreate(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandSelectorCreate(static_cast<int>(params[1]), amx_ctof(params[2]), static_cast<int>(params[3])));
+}
+
+static cell AMX_NATIVE_CALL n_RandSelectorPick(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandSelectorPick(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandSelectorTouch(AMX* amx, cell* params) {
+    return ImplRandSelectorTouch(static_cast<int>(params[1]), static_cast<int>(params[2])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandSelectorSetWeight(AMX* amx, cell* params) {
+    return ImplRandSelectorSetWeight(static_cast<int>(params[1]), static_cast<int>(params[2]), amx_ctof(params[3])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandSelectorReset(AMX* amx, cell* params) {
+    return ImplRandSelectorReset(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandSelectorDestroy(AMX* amx, cell* params) {
+    return ImplRandSelectorDestroy(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+// Team balancing
+
+// players[] (params[1]) is not read: outTeam is indexed by position
+static cell AMX_NATIVE_CALL n_RandTeams(AMX* amx, cell* params) {
+    cell* scores = GetAddr(amx, params[2]);
+    cell* outTeam = GetAddr(amx, params[5]);
+    if (!scores || !outTeam) return 0;
+    
+    return ImplRandTeams(scores, static_cast<int>(params[3]), static_cast<int>(params[4]), outTeam) ? 1 : 0;
+}
+
 // 2D geometry
 
 static cell AMX_NATIVE_CALL n_RandPointInCircle(AMX* amx, cell* params) {
@@ -432,6 +1117,96 @@ static cell AMX_NATIVE_CALL n_RandPointInPolygon(AMX* amx, cell* params) {
     return 1;
 }
 
+static cell AMX_NATIVE_CALL n_RandPoissonDisk(AMX* amx, cell* params) {
+    cell* outX = GetAddr(amx, params[6]);
+    cell* outY = GetAddr(amx, params[7]);
+    if (!outX || !outY) return 0;
+    
+    return static_cast<cell>(ImplRandPoissonDisk(amx_ctof(params[1]), amx_ctof(params[2]), amx_ctof(params[3]), amx_ctof(params[4]),
+        amx_ctof(params[5]), reinterpret_cast<float*>(outX), reinterpret_cast<float*>(outY),
+        static_cast<int>(params[8]), static_cast<uint32_t>(params[9])));
+}
+
+// Async jobs
+
+static cell AMX_NATIVE_CALL n_RandShuffleAsync(AMX* amx, cell* params) {
+    cell* array = GetAddr(amx, params[1]);
+    if (!array) return 0;
+    
+    return static_cast<cell>(ImplRandShuffleAsync(amx, array, static_cast<int>(params[2]), static_cast<uint32_t>(params[3])));
+}
+
+static cell AMX_NATIVE_CALL n_RandPoissonDiskAsync(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandPoissonDiskAsync(amx, amx_ctof(params[1]), amx_ctof(params[2]), amx_ctof(params[3]),
+        amx_ctof(params[4]), amx_ctof(params[5]), static_cast<int>(params[6]), static_cast<uint32_t>(params[7])));
+}
+
+static cell AMX_NATIVE_CALL n_RandJobFetch(AMX* amx, cell* params) {
+    cell* dest = GetAddr(amx, params[2]);
+    if (!dest) return -1;
+    
+    return static_cast<cell>(ImplRandJobFetch(static_cast<int>(params[1]), dest, static_cast<int>(params[3]), static_cast<int>(params[4])));
+}
+
+static cell AMX_NATIVE_CALL n_RandJobFetchPoints(AMX* amx, cell* params) {
+    cell* outX = GetAddr(amx, params[2]);
+    cell* outY = GetAddr(amx, params[3]);
+    if (!outX || !outY) return -1;
+    
+    return static_cast<cell>(ImplRandJobFetchPoints(static_cast<int>(params[1]), reinterpret_cast<float*>(outX),
+        reinterpret_cast<float*>(outY), static_cast<int>(params[4])));
+}
+
+static cell AMX_NATIVE_CALL n_RandJobDone(AMX* amx, cell* params) {
+    return ImplRandJobDone(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+static cell AMX_NATIVE_CALL n_RandJobCancel(AMX* amx, cell* params) {
+    return ImplRandJobCancel(static_cast<int>(params[1])) ? 1 : 0;
+}
+
+// Random events
+
+static cell AMX_NATIVE_CALL n_RandEventExponential(AMX* amx, cell* params) {
+    cell* callback = GetAddr(amx, params[1]);
+    if (!callback) return 0;
+    
+    char nameBuf[32];
+    GetString(callback, nameBuf, sizeof(nameBuf));
+    return static_cast<cell>(ImplRandEventExponential(amx, nameBuf, amx_ctof(params[2]), static_cast<int>(params[3]),
+        static_cast<int>(params[4])));
+}
+
+static cell AMX_NATIVE_CALL n_RandEventUniform(AMX* amx, cell* params) {
+    cell* callback = GetAddr(amx, params[1]);
+    if (!callback) return 0;
+    
+    char nameBuf[32];
+    GetString(callback, nameBuf, sizeof(nameBuf));
+    return static_cast<cell>(ImplRandEventUniform(amx, nameBuf, static_cast<int>(params[2]), static_cast<int>(params[3]),
+        static_cast<int>(params[4]), static_cast<int>(params[5])));
+}
+
+static cell AMX_NATIVE_CALL n_RandEventCustom(AMX* amx, cell* params) {
+    cell* callback = GetAddr(amx, params[1]);
+    cell* delays = GetAddr(amx, params[2]);
+    cell* weights = GetAddr(amx, params[3]);
+    if (!callback || !delays || !weights) return 0;
+    
+    char nameBuf[32];
+    GetString(callback, nameBuf, sizeof(nameBuf));
+    return static_cast<cell>(ImplRandEventCustom(amx, nameBuf, delays, weights, static_cast<int>(params[4]),
+        static_cast<int>(params[5]), static_cast<int>(params[6])));
+}
+
+static cell AMX_NATIVE_CALL n_RandEventRemaining(AMX* amx, cell* params) {
+    return static_cast<cell>(ImplRandEventRemaining(static_cast<int>(params[1])));
+}
+
+static cell AMX_NATIVE_CALL n_RandEventStop(AMX* amx, cell* params) {
+    return ImplRandEventStop(static_cast<int>(params[1])) ? 1 : 0;
+}
+
 // Native registration
 
 AMX_NATIVE_INFO PluginNatives[] = {
@@ -443,12 +1218,105 @@ AMX_NATIVE_INFO PluginNatives[] = {
     {"RandWeighted", n_RandWeighted},
     {"RandShuffle", n_RandShuffle},
     {"RandShuffleRange", n_RandShuffleRange},
+    {"RandShuffleMulti", n_RandShuffleMulti},
+    {"RandShuffleRows", n_RandShuffleRows},
+    {"RandShuffleThreads", n_RandShuffleThreads},
+    {"RandShuffleBegin", n_RandShuffleBegin},
+    {"RandShuffleProgress", n_RandShuffleProgress},
+    {"RandShuffleCancel", n_RandShuffleCancel},
+    {"RandShuffleAsync", n_RandShuffleAsync},
+    {"RandPoissonDisk", n_RandPoissonDisk},
+    {"RandPoissonDiskAsync", n_RandPoissonDiskAsync},
+    {"RandJobFetch", n_RandJobFetch},
+    {"RandJobFetchPoints", n_RandJobFetchPoints},
+    {"RandJobDone", n_RandJobDone},
+    {"RandJobCancel", n_RandJobCancel},
+    {"RandEventExponential", n_RandEventExponential},
+    {"RandEventUniform", n_RandEventUniform},
+    {"RandEventCustom", n_RandEventCustom},
+    {"RandEventRemaining", n_RandEventRemaining},
+    {"RandEventStop", n_RandEventStop},
     {"RandGaussian", n_RandGaussian},
     {"RandDice", n_RandDice},
     {"RandPick", n_RandPick},
     {"RandFormat", n_RandFormat},
+    {"RandFormatChecked", n_RandFormatChecked},
     {"RandBytes", n_RandBytes},
     {"RandUUID", n_RandUUID},
+    {"RandUUIDv7", n_RandUUIDv7},
+    {"RandUUIDBulk", n_RandUUIDBulk},
+    {"RandTokenBase64", n_RandTokenBase64},
+    {"RandCodeVerify", n_RandCodeVerify},
+    {"RandUniqueCodeCreate", n_RandUniqueCodeCreate},
+    {"RandUniqueCodeCreateKeyed", n_RandUniqueCodeCreateKeyed},
+    {"RandUniqueCode", n_RandUniqueCode},
+    {"RandUniqueCodeSpace", n_RandUniqueCodeSpace},
+    {"RandUniqueCodeDestroy", n_RandUniqueCodeDestroy},
+    {"RandFilterCreate", n_RandFilterCreate},
+    {"RandFilterAddWord", n_RandFilterAddWord},
+    {"RandFilterLoad", n_RandFilterLoad},
+    {"RandFilterCheck", n_RandFilterCheck},
+    {"RandFilterWordCount", n_RandFilterWordCount},
+    {"RandFilterDestroy", n_RandFilterDestroy},
+    {"RandFormatFiltered", n_RandFormatFiltered},
+    {"RandRegexCompile", n_RandRegexCompile},
+    {"RandRegex", n_RandRegex},
+    {"RandRegexMaxLength", n_RandRegexMaxLength},
+    {"RandRegexDestroy", n_RandRegexDestroy},
+    {"RandMarkovCreate", n_RandMarkovCreate},
+    {"RandMarkovTrain", n_RandMarkovTrain},
+    {"RandMarkovLoad", n_RandMarkovLoad},
+    {"RandMarkovName", n_RandMarkovName},
+    {"RandMarkovNameCount", n_RandMarkovNameCount},
+    {"RandMarkovDestroy", n_RandMarkovDestroy},
+    {"RandPassphrase", n_RandPassphrase},
+    {"RandPassphraseWordCount", n_RandPassphraseWordCount},
+    {"RandDeckCreate", n_RandDeckCreate},
+    {"RandDeckDraw", n_RandDeckDraw},
+    {"RandDeckReturn", n_RandDeckReturn},
+    {"RandDeckReshuffle", n_RandDeckReshuffle},
+    {"RandDeckRemaining", n_RandDeckRemaining},
+    {"RandDeckSize", n_RandDeckSize},
+    {"RandDeckDestroy", n_RandDeckDestroy},
+    {"RandUniqueRangeCreate", n_RandUniqueRangeCreate},
+    {"RandUniqueNext", n_RandUniqueNext},
+    {"RandUniqueRangeRemaining", n_RandUniqueRangeRemaining},
+    {"RandUniqueRangeReset", n_RandUniqueRangeReset},
+    {"RandUniqueRangeDestroy", n_RandUniqueRangeDestroy},
+    {"RandRangeExcluding", n_RandRangeExcluding},
+    {"RandIntSetCreate", n_RandIntSetCreate},
+    {"RandIntSetExclude", n_RandIntSetExclude},
+    {"RandIntSetInclude", n_RandIntSetInclude},
+    {"RandIntSetContains", n_RandIntSetContains},
+    {"RandIntSetCount", n_RandIntSetCount},
+    {"RandIntSetPick", n_RandIntSetPick},
+    {"RandIntSetDestroy", n_RandIntSetDestroy},
+    {"RandLootLoad", n_RandLootLoad},
+    {"RandLootTable", n_RandLootTable},
+    {"RandLootRoll", n_RandLootRoll},
+    {"RandSelectorCreate", n_RandSelectorCreate},
+    {"RandSelectorPick", n_RandSelectorPick},
+    {"RandSelectorTouch", n_RandSelectorTouch},
+    {"RandSelectorSetWeight", n_RandSelectorSetWeight},
+    {"RandSelectorReset", n_RandSelectorReset},
+    {"RandSelectorDestroy", n_RandSelectorDestroy},
+    {"RandTeams", n_RandTeams},
+    {"RandRegistryCreate", n_RandRegistryCreate},
+    {"RandRegistryAdd", n_RandRegistryAdd},
+    {"RandRegistryContains", n_RandRegistryContains},
+    {"RandRegistryRemove", n_RandRegistryRemove},
+    {"RandRegistryCount", n_RandRegistryCount},
+    {"RandRegistrySave", n_RandRegistrySave},
+    {"RandRegistryLoad", n_RandRegistryLoad},
+    {"RandRegistryDestroy", n_RandRegistryDestroy},
+    {"RandFormatUnique", n_RandFormatUnique},
+    {"RandPermCreate", n_RandPermCreate},
+    {"RandPermAt", n_RandPermAt},
+    {"RandPermIndexOf", n_RandPermIndexOf},
+    {"RandPermSize", n_RandPermSize},
+    {"RandPermDestroy", n_RandPermDestroy},
+    {"RandTokenBase32", n_RandTokenBase32},
+    {"RandTokenCrockford", n_RandTokenCrockford},
     {"RandPointInCircle", n_RandPointInCircle},
     {"RandPointOnCircle", n_RandPointOnCircle},
     {"RandPointInRect", n_RandPointInRect},
@@ -468,5 +1336,12 @@ PLUGIN_EXPORT int PLUGIN_CALL AmxLoad(AMX* amx) {
 }
 
 PLUGIN_EXPORT int PLUGIN_CALL AmxUnload(AMX* amx) {
+    ReleaseScriptJobs(amx);
     return AMX_ERR_NONE;
 }
+
+PLUGIN_EXPORT void PLUGIN_CALL ProcessTick() {
+    ProcessSlicedShuffles();
+    ProcessRandEvents();
+    DispatchCallbacks();
+}
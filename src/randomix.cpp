@@ -2,6 +2,7 @@
 #include <chrono>
 #include <algorithm>
 #include <cstring>
+#include <cstdio>
 
 // OS-specific headers for system entropy
 #ifdef _WIN32
@@ -10,9 +11,13 @@
     #undef max
 #elif defined(__linux__)
     #include <sys/syscall.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
     #include <unistd.h>
     #include <fcntl.h>
 #elif defined(__unix__) || defined(__APPLE__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
     #include <unistd.h>
     #include <fcntl.h>
 #endif
@@ -250,6 +255,36 @@ void ChaChaRNG::next_bytes(uint8_t* buffer, size_t length) {
     }
 }
 
+void ChaChaRNG::keyed_block(const uint32_t* key, uint64_t counter, uint64_t nonce, uint32_t* output, int rounds) {
+    uint32_t input[16];
+    std::copy(CONSTANTS, CONSTANTS + 4, input);
+    std::copy(key, key + 8, input + 4);
+    input[12] = static_cast<uint32_t>(counter);
+    input[13] = static_cast<uint32_t>(counter >> 32);
+    input[14] = static_cast<uint32_t>(nonce);
+    input[15] = static_cast<uint32_t>(nonce >> 32);
+    
+    std::copy(input, input + 16, output);
+    
+    for (int i = 0; i < rounds; i += 2) {
+        quarter_round(output[0], output[4], output[8], output[12]);
+        quarter_round(output[1], output[5], output[9], output[13]);
+        quarter_round(output[2], output[6], output[10], output[14]);
+        quarter_round(output[3], output[7], output[11], output[15]);
+        
+        quarter_round(output[0], output[5], output[10], output[15]);
+        quarter_round(output[1], output[6], output[11], output[12]);
+        quarter_round(output[2], output[7], output[8], output[13]);
+        quarter_round(output[3], output[4], output[9], output[14]);
+    }
+    
+    for (int i = 0; i < 16; ++i) {
+        output[i] += input[i];
+    }
+    
+    std::fill(input, input + 16, 0);
+}
+
 ChaChaRNG::~ChaChaRNG() {
     std::fill(state.begin(), state.end(), 0);
     std::fill(block, block + 16, 0);
@@ -258,6 +293,87 @@ ChaChaRNG::~ChaChaRNG() {
     position = 0;
 }
 
+// MappedFile Implementation
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const char* path) {
+    close();
+    
+    #ifdef _WIN32
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+            CloseHandle(file);
+            return false;
+        }
+        
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            return false;
+        }
+        
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        
+        file_ = file;
+        mapping_ = mapping;
+        data_ = static_cast<const char*>(view);
+        size_ = static_cast<size_t>(size.QuadPart);
+    #else
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        
+        void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) return false;
+        
+        data_ = static_cast<const char*>(view);
+        size_ = static_cast<size_t>(st.st_size);
+    #endif
+    
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_ == nullptr) return;
+    
+    #ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(static_cast<HANDLE>(mapping_));
+        CloseHandle(static_cast<HANDLE>(file_));
+        file_ = nullptr;
+        mapping_ = nullptr;
+    #else
+        munmap(const_cast<char*>(data_), size_);
+    #endif
+    
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool AtomicReplaceFile(const char* from, const char* to) {
+    #ifdef _WIN32
+        return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    #else
+        return std::rename(from, to) == 0;
+    #endif
+}
+
 // Global Singleton Implementation
 namespace Randomix {
     std::mutex rng_mutex;
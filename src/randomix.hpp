@@ -19,7 +19,7 @@ private:
     };
     
     static inline uint32_t rotl32(uint32_t x, int n);
-    void quarter_round(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d);
+    static void quarter_round(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d);
     uint64_t get_os_entropy();
     void generate_block();
     void check_reseed();
@@ -40,8 +40,37 @@ public:
     [[nodiscard]] float next_float() noexcept;
     [[nodiscard]] uint32_t next_bounded(uint32_t bound);
     void next_bytes(uint8_t* buffer, size_t length);
+    
+    // Stateless ChaCha block for keyed constructions (PRFs, permutations)
+    static void keyed_block(const uint32_t* key, uint64_t counter, uint64_t nonce, uint32_t* output, int rounds = ROUNDS);
 };
 
+// Read-only memory-mapped file (mmap / Windows file mapping)
+class MappedFile {
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+    
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    bool open(const char* path);
+    void close();
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+};
+
+// Move `from` over `to`, replacing it atomically (rename / MoveFileEx)
+bool AtomicReplaceFile(const char* from, const char* to);
+
 // Global Singleton
 namespace Randomix {
     extern std::mutex rng_mutex;
@@ -13,6 +13,20 @@
 #include <algorithm>
 #include <cstring>
 #include <climits>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <bitset>
+#include <map>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <new>
+#include <functional>
+#include <deque>
+#include <condition_variable>
 
 // Constants
 
@@ -48,6 +62,168 @@ inline bool CheckValidProbability(float prob) {
     return !std::isnan(prob) && !std::isinf(prob);
 }
 
+// Handle registries
+// Script-facing objects are owned here and referenced by integer handles.
+// Ids start at 1 so 0 stays the invalid handle; freed slots are reused.
+// Natives run on the server thread, so pools are not locked.
+
+template<typename T>
+class HandlePool {
+private:
+    std::vector<std::unique_ptr<T>> slots_;
+    
+public:
+    int Add(std::unique_ptr<T> object) {
+        if (!object) return 0;
+        for (size_t i = 0; i < slots_.size(); i++) {
+            if (!slots_[i]) {
+                slots_[i] = std::move(object);
+                return static_cast<int>(i) + 1;
+            }
+        }
+        if (slots_.size() >= 65536) return 0;
+        slots_.push_back(std::move(object));
+        return static_cast<int>(slots_.size());
+    }
+    
+    T* Get(int handle) const {
+        if (handle <= 0 || handle > static_cast<int>(slots_.size())) return nullptr;
+        return slots_[handle - 1].get();
+    }
+    
+    bool Remove(int handle) {
+        if (!Get(handle)) return false;
+        slots_[handle - 1].reset();
+        return true;
+    }
+    
+    // Highest handle ever issued (live or freed)
+    int Capacity() const { return static_cast<int>(slots_.size()); }
+};
+
+// Script callbacks
+// Deferred work reports back by queueing a public call for the script that
+// started it (`owner` is the AMX, opaque here). The plugin drains the queue
+// on the server thread every tick; producers may run on any thread.
+
+struct ScriptCallback {
+    void* owner;
+    std::string name;
+    std::vector<int32_t> args;
+    std::function<void()> after = nullptr;   // Runs on the server thread after the call
+};
+
+class CallbackQueue {
+private:
+    std::mutex mutex_;
+    std::vector<ScriptCallback> items_;
+    
+public:
+    void Push(ScriptCallback callback) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.push_back(std::move(callback));
+    }
+    
+    void Drain(std::vector<ScriptCallback>& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out.swap(items_);
+        items_.clear();
+    }
+    
+    void DropOwner(void* owner) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.erase(std::remove_if(items_.begin(), items_.end(),
+            [owner](const ScriptCallback& cb) { return cb.owner == owner; }), items_.end());
+    }
+};
+
+inline CallbackQueue& PendingCallbacks() {
+    static CallbackQueue queue;
+    return queue;
+}
+
+// Data files live under scriptfiles/, like the Pawn file natives.
+// Rejects absolute paths and parent-directory components.
+inline bool ScriptFilePath(const char* name, std::string& out) {
+    if (name == nullptr || name[0] == '\0') return false;
+    if (name[0] == '/' || name[0] == '\\' || std::strchr(name, ':')) return false;
+    if (std::strstr(name, "..")) return false;
+    
+    out = "scriptfiles/";
+    out += name;
+    return true;
+}
+
+// Stable 64-bit string hash (FNV-1a + splitmix64 finalizer); safe to persist
+inline uint64_t HashString(const char* str, size_t len) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= static_cast<uint8_t>(str[i]);
+        h *= 0x100000001B3ULL;
+    }
+    h ^= h >> 30; h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27; h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+// Uniform double in [0, 1) with full 53-bit precision. Caller must hold rng_mutex
+inline double NextUnitDouble(ChaChaRNG& rng) {
+    uint64_t hi = rng.next_uint32() >> 5;
+    uint64_t lo = rng.next_uint32() >> 6;
+    return static_cast<double>((hi << 26) | lo) * (1.0 / 9007199254740992.0);
+}
+
+// Walker/Vose alias table: O(n) build, O(1) weighted draw
+class AliasTable {
+private:
+    std::vector<uint64_t> threshold_;   // Keep index i if draw < threshold (scale 2^32)
+    std::vector<uint32_t> alias_;
+    
+public:
+    // Returns false if there is no positive weight
+    bool Build(const std::vector<double>& weights) {
+        size_t n = weights.size();
+        double total = 0.0;
+        for (double w : weights) {
+            if (w > 0.0) total += w;
+        }
+        threshold_.assign(n, 0);
+        alias_.assign(n, 0);
+        if (n == 0 || !(total > 0.0) || !std::isfinite(total)) return false;
+        
+        std::vector<double> scaled(n);
+        std::vector<uint32_t> small, large;
+        for (size_t i = 0; i < n; i++) {
+            scaled[i] = (weights[i] > 0.0 ? weights[i] : 0.0) * n / total;
+            (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+        }
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back(); small.pop_back();
+            uint32_t l = large.back();
+            threshold_[s] = static_cast<uint64_t>(scaled[s] * 4294967296.0);
+            alias_[s] = l;
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // Leftovers are 1.0 up to rounding
+        for (uint32_t i : large) threshold_[i] = 1ULL << 32;
+        for (uint32_t i : small) threshold_[i] = 1ULL << 32;
+        return true;
+    }
+    
+    size_t Size() const { return threshold_.size(); }
+    
+    // Caller must hold rng_mutex
+    uint32_t Sample(ChaChaRNG& rng) const {
+        uint32_t i = rng.next_bounded(static_cast<uint32_t>(threshold_.size()));
+        return rng.next_uint32() < threshold_[i] ? i : alias_[i];
+    }
+};
+
 // Core random functions
 
 inline int ImplRandRange(int min, int max) {
@@ -90,17 +266,20 @@ inline bool ImplRandBoolWeighted(int trueWeight, int falseWeight) {
     return Randomix::GetRNG().next_bounded(total) < static_cast<uint32_t>(trueWeight);
 }
 
-inline int ImplRandWeighted(const int* weights, int count) {
-    if (count <= 0 || weights == nullptr) return 0;
+// `stride` is the distance in cells between consecutive weights, so a weight
+// column of an enum array can be read in place (pass the first weight cell)
+inline int ImplRandWeighted(const int* weights, int count, int stride = 1) {
+    if (count <= 0 || weights == nullptr || stride <= 0) return 0;
     if (count > 65536) return 0;
     
     uint32_t total = 0;
     for (int i = 0; i < count; i++) {
-        if (weights[i] > 0) {
-            if (weights[i] > static_cast<int>(UINT32_MAX - total)) {
+        int w = weights[static_cast<size_t>(i) * stride];
+        if (w > 0) {
+            if (static_cast<uint32_t>(w) > UINT32_MAX - total) {
                 return 0;
             }
-            total += static_cast<uint32_t>(weights[i]);
+            total += static_cast<uint32_t>(w);
         }
     }
     
@@ -111,8 +290,9 @@ inline int ImplRandWeighted(const int* weights, int count) {
     uint32_t sum = 0;
     
     for (int i = 0; i < count; i++) {
-        if (weights[i] > 0) {
-            sum += static_cast<uint32_t>(weights[i]);
+        int w = weights[static_cast<size_t>(i) * stride];
+        if (w > 0) {
+            sum += static_cast<uint32_t>(w);
             if (rand < sum) return i;
         }
     }
@@ -120,18 +300,200 @@ inline int ImplRandWeighted(const int* weights, int count) {
     return count - 1;
 }
 
-inline bool ImplRandShuffle(int* array, int count) {
+// Worker threads for large shuffles (1 = shuffle on the calling thread)
+inline std::atomic<int>& ShuffleThreads() {
+    static std::atomic<int> threads{1};
+    return threads;
+}
+
+// Arrays at least this long take the bucketed path (past typical L2 size)
+constexpr size_t LARGE_SHUFFLE_MIN = 1u << 18;
+
+// Independent ChaCha20 keystream for worker threads, keyed from the global
+// RNG. Hands out 16-bit halves too, since bucket-sized draws need no more.
+class SubStream {
+private:
+    uint32_t key_[8];
+    uint64_t counter_ = 0;
+    uint32_t block_[16];
+    int position_ = 16;
+    uint32_t half_ = 0;
+    bool hasHalf_ = false;
+    
+public:
+    // Caller must hold rng_mutex
+    explicit SubStream(ChaChaRNG& rng) {
+        for (int i = 0; i < 8; i++) key_[i] = rng.next_uint32();
+    }
+    
+    explicit SubStream(const uint32_t* key) {
+        std::copy(key, key + 8, key_);
+    }
+    
+    ~SubStream() {
+        std::fill(key_, key_ + 8, 0);
+        std::fill(block_, block_ + 16, 0);
+    }
+    
+    uint32_t Next() {
+        if (position_ >= 16) {
+            ChaChaRNG::keyed_block(key_, counter_++, 0, block_);
+            position_ = 0;
+        }
+        return block_[position_++];
+    }
+    
+    uint32_t Next16() {
+        if (hasHalf_) {
+            hasHalf_ = false;
+            return half_;
+        }
+        uint32_t word = Next();
+        half_ = word >> 16;
+        hasHalf_ = true;
+        return word & 0xFFFF;
+    }
+    
+    // Uniform float in [0, 1)
+    float NextFloat() {
+        return static_cast<float>(Next() >> 8) / 16777216.0f;
+    }
+    
+    // Unbiased draw in [0, bound) (Lemire), 16-bit words when bound fits
+    uint32_t Bounded(uint32_t bound) {
+        if (bound <= 1) return 0;
+        if (bound <= 0x10000) {
+            uint32_t m = Next16() * bound;
+            if ((m & 0xFFFF) < bound) {
+                uint32_t threshold = (0x10000 - bound) % bound;
+                while ((m & 0xFFFF) < threshold) m = Next16() * bound;
+            }
+            return m >> 16;
+        }
+        uint64_t m = static_cast<uint64_t>(Next()) * bound;
+        if (static_cast<uint32_t>(m) < bound) {
+            uint32_t threshold = (0u - bound) % bound;
+            while (static_cast<uint32_t>(m) < threshold) m = static_cast<uint64_t>(Next()) * bound;
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+};
+
+// Scatter shuffle for large arrays: every element gets a uniform random
+// bucket label, elements are scattered into a scratch buffer by label, then
+// each bucket (~32K elements, cache resident) is Fisher-Yates shuffled and
+// copied back. Uniform labels plus uniform in-bucket shuffles give a uniform
+// permutation, while memory is only streamed, never hit at random. Work is
+// split over `threads`, each with its own SubStream. Returns false if the
+// scratch buffers cannot be allocated.
+inline bool LargeShuffle(int* array, size_t count, int threads) {
+    int bits = 1;
+    while (bits < 12 && (count >> (bits + 15)) > 0) bits++;
+    const size_t buckets = size_t(1) << bits;
+    
+    std::unique_ptr<int[]> scratch(new (std::nothrow) int[count]);
+    std::unique_ptr<uint16_t[]> labels(new (std::nothrow) uint16_t[count]);
+    if (!scratch || !labels) return false;
+    
+    if (threads < 1) threads = 1;
+    if (threads > 64) threads = 64;
+    const size_t chunk = (count + threads - 1) / threads;
+    
+    std::vector<std::unique_ptr<SubStream>> streams;
+    {
+        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+        for (int t = 0; t < threads; t++) {
+            streams.push_back(std::make_unique<SubStream>(Randomix::GetRNG()));
+        }
+    }
+    
+    auto run = [threads](auto&& fn) {
+        if (threads == 1) {
+            fn(0);
+            return;
+        }
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) workers.emplace_back(fn, t);
+        for (auto& w : workers) w.join();
+    };
+    
+    // Pass 1: labels and per-chunk bucket sizes
+    std::vector<size_t> slots(static_cast<size_t>(threads) * buckets, 0);
+    run([&](int t) {
+        size_t begin = std::min(count, t * chunk), end = std::min(count, begin + chunk);
+        size_t* hist = &slots[t * buckets];
+        SubStream& rng = *streams[t];
+        for (size_t i = begin; i < end; i++) {
+            uint16_t label = static_cast<uint16_t>(rng.Next16() >> (16 - bits));
+            labels[i] = label;
+            hist[label]++;
+        }
+    });
+    
+    // Bucket-major, chunk-minor write positions
+    std::vector<size_t> bucketStart(buckets + 1);
+    size_t pos = 0;
+    for (size_t b = 0; b < buckets; b++) {
+        bucketStart[b] = pos;
+        for (int t = 0; t < threads; t++) {
+            size_t n = slots[t * buckets + b];
+            slots[t * buckets + b] = pos;
+            pos += n;
+        }
+    }
+    bucketStart[buckets] = pos;
+    
+    // Pass 2: scatter
+    run([&](int t) {
+        size_t begin = std::min(count, t * chunk), end = std::min(count, begin + chunk);
+        size_t* next = &slots[t * buckets];
+        for (size_t i = begin; i < end; i++) {
+            scratch[next[labels[i]]++] = array[i];
+        }
+    });
+    
+    // Pass 3: shuffle buckets in cache and copy back
+    run([&](int t) {
+        SubStream& rng = *streams[t];
+        for (size_t b = t; b < buckets; b += threads) {
+            int* base = scratch.get() + bucketStart[b];
+            size_t n = bucketStart[b + 1] - bucketStart[b];
+            for (size_t i = n; i > 1; i--) {
+                std::swap(base[i - 1], base[rng.Bounded(static_cast<uint32_t>(i))]);
+            }
+            std::copy(base, base + n, array + bucketStart[b]);
+        }
+    });
+    return true;
+}
+
+// With stride > 1 the array holds `count` records of `stride` cells each,
+// and whole records are swapped
+inline bool ImplRandShuffle(int* array, int count, int stride = 1) {
     if (count <= 1) return true;
-    if (array == nullptr) return false;
-    if (count > 10000000) return false;
+    if (array == nullptr || stride <= 0) return false;
+    
+    if (stride == 1 && static_cast<size_t>(count) >= LARGE_SHUFFLE_MIN) {
+        if (LargeShuffle(array, static_cast<size_t>(count), ShuffleThreads().load())) return true;
+    }
     
     std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
     
+    if (stride == 1) {
+        for (int i = count - 1; i > 0; i--) {
+            int j = static_cast<int>(Randomix::GetRNG().next_bounded(i + 1));
+            std::swap(array[i], array[j]);
+        }
+        return true;
+    }
+    
     for (int i = count - 1; i > 0; i--) {
         int j = static_cast<int>(Randomix::GetRNG().next_bounded(i + 1));
-        std::swap(array[i], array[j]);
+        if (j != i) {
+            int* a = array + static_cast<size_t>(i) * stride;
+            std::swap_ranges(a, a + stride, array + static_cast<size_t>(j) * stride);
+        }
     }
-    
     return true;
 }
 
@@ -140,7 +502,10 @@ inline bool ImplRandShuffleRange(int* array, int start, int end) {
     if (start > end) std::swap(start, end);
     if (end - start < 1) return true;
     if (start < 0) return false;
-    if (end > 10000000) return false;
+    
+    if (static_cast<size_t>(end - start) + 1 >= LARGE_SHUFFLE_MIN) {
+        if (LargeShuffle(array + start, static_cast<size_t>(end - start) + 1, ShuffleThreads().load())) return true;
+    }
     
     std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
     
@@ -151,130 +516,3419 @@ inline bool ImplRandShuffleRange(int* array, int start, int end) {
     return true;
 }
 
+inline bool ImplRandShuffleThreads(int threads) {
+    if (threads < 1 || threads > 64) return false;
+    ShuffleThreads().store(threads);
+    return true;
+}
+
+// One permutation applied to several parallel arrays. The swap targets are
+// drawn once, then replayed array by array so each pass streams through a
+// single array instead of touching every array on every swap.
+inline bool ImplRandShuffleMulti(int* const* arrays, int arrayCount, int count) {
+    if (count <= 1) return true;
+    if (arrays == nullptr || arrayCount <= 0) return false;
+    if (count > 10000000) return false;
+    
+    std::vector<uint32_t> swaps(static_cast<size_t>(count));
+    {
+        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+        auto& rng = Randomix::GetRNG();
+        for (int i = count - 1; i > 0; i--) {
+            swaps[i] = rng.next_bounded(static_cast<uint32_t>(i + 1));
+        }
+    }
+    
+    for (int a = 0; a < arrayCount; a++) {
+        int* array = arrays[a];
+        if (array == nullptr) continue;
+        for (int i = count - 1; i > 0; i--) {
+            std::swap(array[i], array[swaps[i]]);
+        }
+    }
+    return true;
+}
+
+// Shuffle whole rows of a 2D array; each swap moves `cols` contiguous cells
+inline bool ImplRandShuffleRows(int* const* rows, int rowCount, int cols) {
+    if (rowCount <= 1) return true;
+    if (rows == nullptr || cols <= 0) return false;
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    auto& rng = Randomix::GetRNG();
+    
+    for (int i = rowCount - 1; i > 0; i--) {
+        int j = static_cast<int>(rng.next_bounded(static_cast<uint32_t>(i + 1)));
+        if (j != i) std::swap_ranges(rows[i], rows[i] + cols, rows[j]);
+    }
+    return true;
+}
+
 inline int ImplRandGaussian(float mean, float stddev) {
     if (stddev <= 0.0f) return static_cast<int>(mean);
     if (!CheckPositive(stddev)) return static_cast<int>(mean);
     if (std::isnan(mean) || std::isinf(mean)) return 0;
     
-    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    
+    float u1 = Randomix::GetRNG().next_float();
+    float u2 = Randomix::GetRNG().next_float();
+    if (u1 < 1e-10f) u1 = 1e-10f;
+    
+    float z0 = std::sqrt(-2.0f * std::log(u1)) * std::cos(TWO_PI * u2);
+    float result = mean + z0 * stddev;
+    
+    return static_cast<int>(result < 0.0f ? 0.0f : result);
+}
+
+inline int ImplRandDice(int sides, int count) {
+    if (sides <= 0 || count <= 0) return 0;
+    if (sides > 10000 || count > 10000) return 0;
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    uint32_t total = 0;
+    uint32_t uSides = static_cast<uint32_t>(sides);
+    
+    for (int i = 0; i < count; i++) {
+        total += Randomix::GetRNG().next_bounded(uSides) + 1;
+    }
+    
+    return static_cast<int>(total);
+}
+
+inline int ImplRandPick(const int* array, int count, int stride = 1) {
+    if (count <= 0 || array == nullptr || stride <= 0) return 0;
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    uint32_t idx = Randomix::GetRNG().next_bounded(static_cast<uint32_t>(count));
+    return array[static_cast<size_t>(idx) * stride];
+}
+
+// String & token functions
+
+// Check symbols for typo-resistant codes. Both cover every alphanumeric
+// character before the check position (literals included, separators skipped).
+
+enum class CheckAlgorithm {
+    Damm = 0,   // Digits only, 0-9 check digit
+    Luhn36 = 1  // Luhn mod N over 0-9A-Z, case-insensitive
+};
+
+inline int CheckCodePoint36(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'z') return c - 'a' + 10;
+    return -1;
+}
+
+// Returns the interim Damm digit; 0 means the sequence (with its check digit) is valid
+inline int DammInterim(const char* str, int len) {
+    static const uint8_t table[10][10] = {
+        {0, 3, 1, 7, 5, 9, 8, 6, 4, 2},
+        {7, 0, 9, 2, 1, 5, 4, 8, 6, 3},
+        {4, 2, 0, 6, 8, 7, 1, 3, 5, 9},
+        {1, 7, 5, 0, 9, 8, 3, 4, 2, 6},
+        {6, 1, 2, 3, 0, 4, 5, 9, 7, 8},
+        {3, 6, 7, 4, 2, 0, 9, 5, 8, 1},
+        {5, 8, 6, 9, 7, 2, 0, 1, 3, 4},
+        {8, 9, 4, 5, 3, 6, 2, 0, 1, 7},
+        {9, 4, 3, 8, 6, 1, 7, 2, 0, 5},
+        {2, 5, 8, 1, 4, 3, 6, 7, 9, 0}
+    };
+    
+    int interim = 0;
+    for (int i = 0; i < len; i++) {
+        if (str[i] >= '0' && str[i] <= '9') {
+            interim = table[interim][str[i] - '0'];
+        }
+    }
+    return interim;
+}
+
+// Luhn mod 36 sum; `factor` is the weight of the rightmost code point
+inline int Luhn36Sum(const char* str, int len, int factor) {
+    int sum = 0;
+    for (int i = len - 1; i >= 0; i--) {
+        int cp = CheckCodePoint36(str[i]);
+        if (cp < 0) continue;
+        int addend = factor * cp;
+        sum += addend / 36 + addend % 36;
+        factor = (factor == 2) ? 1 : 2;
+    }
+    return sum % 36;
+}
+
+inline char ComputeCheckSymbol(const char* str, int len, CheckAlgorithm algorithm) {
+    static const char* base36 = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    
+    if (algorithm == CheckAlgorithm::Damm) {
+        return static_cast<char>('0' + DammInterim(str, len));
+    }
+    return base36[(36 - Luhn36Sum(str, len, 2)) % 36];
+}
+
+// The check symbol must be the last alphanumeric character of the code
+inline bool ImplRandCodeVerify(const char* code, int algorithm) {
+    if (code == nullptr) return false;
+    int len = static_cast<int>(std::strlen(code));
+    
+    if (algorithm == static_cast<int>(CheckAlgorithm::Damm)) {
+        bool hasDigit = false;
+        for (int i = 0; i < len && !hasDigit; i++) {
+            hasDigit = (code[i] >= '0' && code[i] <= '9');
+        }
+        return hasDigit && DammInterim(code, len) == 0;
+    }
+    if (algorithm == static_cast<int>(CheckAlgorithm::Luhn36)) {
+        bool hasSymbol = false;
+        for (int i = 0; i < len && !hasSymbol; i++) {
+            hasSymbol = CheckCodePoint36(code[i]) >= 0;
+        }
+        return hasSymbol && Luhn36Sum(code, len, 1) == 0;
+    }
+    return false;
+}
+
+// Blocklist filter - Aho-Corasick automaton over a wordlist, compiled to a
+// dense DFA. Matching is case-insensitive, optionally folds leetspeak digits
+// (0=o 1=i 3=e 4=a 5=s 7=t 8=b), and skips non-alphanumerics so "F-U-C-K"
+// still matches. Generators scan while they emit and only regenerate the
+// offending segment.
+
+class BlockFilter {
+private:
+    static constexpr int SYMBOLS = 36;  // a-z, 0-9
+    
+    bool leet_;
+    bool dirty_ = true;
+    std::vector<std::string> words_;
+    std::vector<int32_t> next_;         // state * SYMBOLS + symbol
+    std::vector<uint16_t> matchLen_;    // Longest word ending in each state
+    
+    void Compile() {
+        next_.assign(SYMBOLS, -1);
+        matchLen_.assign(1, 0);
+        std::vector<uint16_t> depth(1, 0);
+        
+        for (const auto& word : words_) {
+            int32_t state = 0;
+            for (char c : word) {
+                int sym = Symbol(c);
+                if (sym < 0) continue;
+                if (next_[state * SYMBOLS + sym] < 0) {
+                    next_[state * SYMBOLS + sym] = static_cast<int32_t>(matchLen_.size());
+                    next_.insert(next_.end(), SYMBOLS, -1);
+                    matchLen_.push_back(0);
+                    depth.push_back(static_cast<uint16_t>(depth[state] + 1));
+                }
+                state = next_[state * SYMBOLS + sym];
+            }
+            if (state != 0) matchLen_[state] = depth[state];
+        }
+        
+        // BFS: fill missing transitions from fail links (full DFA) and
+        // inherit the longest match reachable through the fail chain
+        std::vector<int32_t> fail(matchLen_.size(), 0);
+        std::vector<int32_t> queue;
+        queue.reserve(matchLen_.size());
+        for (int sym = 0; sym < SYMBOLS; sym++) {
+            int32_t& target = next_[sym];
+            if (target < 0) {
+                target = 0;
+            } else {
+                queue.push_back(target);
+            }
+        }
+        for (size_t head = 0; head < queue.size(); head++) {
+            int32_t state = queue[head];
+            matchLen_[state] = std::max(matchLen_[state], matchLen_[fail[state]]);
+            for (int sym = 0; sym < SYMBOLS; sym++) {
+                int32_t& target = next_[state * SYMBOLS + sym];
+                int32_t viaFail = next_[fail[state] * SYMBOLS + sym];
+                if (target < 0) {
+                    target = viaFail;
+                } else {
+                    fail[target] = viaFail;
+                    queue.push_back(target);
+                }
+            }
+        }
+        dirty_ = false;
+    }
+    
+public:
+    explicit BlockFilter(bool leet) : leet_(leet) {}
+    
+    // Automaton symbol for a character, -1 for characters the scan skips
+    int Symbol(char c) const {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a';
+        if (c >= '0' && c <= '9') {
+            if (leet_) {
+                static const char* leet = "oi2eas6tb9";
+                char folded = leet[c - '0'];
+                if (folded >= 'a') return folded - 'a';
+            }
+            return 26 + (c - '0');
+        }
+        return -1;
+    }
+    
+    bool AddWord(const char* word) {
+        std::string w;
+        for (const char* p = word; *p; p++) {
+            if (Symbol(*p) >= 0) w += *p;
+        }
+        if (w.empty() || w.size() > 255) return false;
+        words_.push_back(w);
+        dirty_ = true;
+        return true;
+    }
+    
+    int WordCount() const { return static_cast<int>(words_.size()); }
+    
+    void Prepare() {
+        if (dirty_) Compile();
+    }
+    
+    // Call Prepare() first
+    int32_t Step(int32_t state, int sym) const { return next_[state * SYMBOLS + sym]; }
+    int MatchLength(int32_t state) const { return matchLen_[state]; }
+    
+    bool Matches(const char* text) {
+        Prepare();
+        int32_t state = 0;
+        for (const char* p = text; *p; p++) {
+            int sym = Symbol(*p);
+            if (sym < 0) continue;
+            state = Step(state, sym);
+            if (matchLen_[state]) return true;
+        }
+        return false;
+    }
+};
+
+// Incremental scan of generated output. Push() the character at each
+// position (positions may go back after a rewind); a nonzero return is the
+// output position where the blocked word starts, i.e. where to regenerate.
+class FilterScan {
+private:
+    BlockFilter* filter_;
+    std::vector<int32_t> stateAfter_;   // Per output position
+    std::vector<int> symbolsAfter_;     // Alphanumerics consumed through each position
+    std::vector<int> symbolPos_;        // Output position of each consumed alphanumeric
+    
+public:
+    explicit FilterScan(BlockFilter* filter) : filter_(filter) {
+        if (filter_) filter_->Prepare();
+    }
+    
+    // Returns -1 if clean, else the start position of the match
+    int Push(int pos, char c) {
+        if (!filter_) return -1;
+        
+        stateAfter_.resize(pos);
+        symbolsAfter_.resize(pos);
+        int32_t state = pos ? stateAfter_[pos - 1] : 0;
+        int symbols = pos ? symbolsAfter_[pos - 1] : 0;
+        symbolPos_.resize(symbols);
+        
+        int sym = filter_->Symbol(c);
+        if (sym >= 0) {
+            state = filter_->Step(state, sym);
+            symbolPos_.push_back(pos);
+            symbols++;
+        }
+        stateAfter_.push_back(state);
+        symbolsAfter_.push_back(symbols);
+        
+        int match = (sym >= 0) ? filter_->MatchLength(state) : 0;
+        return match ? symbolPos_[symbols - match] : -1;
+    }
+};
+
+inline HandlePool<BlockFilter>& FilterPool() {
+    static HandlePool<BlockFilter> pool;
+    return pool;
+}
+
+inline int ImplRandFilterCreate(bool leet) {
+    return FilterPool().Add(std::make_unique<BlockFilter>(leet));
+}
+
+inline bool ImplRandFilterAddWord(int handle, const char* word) {
+    BlockFilter* filter = FilterPool().Get(handle);
+    if (filter == nullptr || word == nullptr) return false;
+    return filter->AddWord(word);
+}
+
+// One word per line; blank lines and lines starting with ';' are skipped.
+// Returns a new filter handle, 0 if the file cannot be read.
+inline int ImplRandFilterLoad(const char* filename, bool leet) {
+    std::string path;
+    if (!ScriptFilePath(filename, path)) return 0;
+    
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return 0;
+    
+    auto filter = std::make_unique<BlockFilter>(leet);
+    char line[512];
+    while (std::fgets(line, sizeof(line), f)) {
+        line[std::strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == ';') continue;
+        filter->AddWord(line);
+    }
+    std::fclose(f);
+    
+    return FilterPool().Add(std::move(filter));
+}
+
+inline bool ImplRandFilterCheck(int handle, const char* text) {
+    BlockFilter* filter = FilterPool().Get(handle);
+    if (filter == nullptr || text == nullptr) return false;
+    return filter->Matches(text);
+}
+
+inline int ImplRandFilterWordCount(int handle) {
+    BlockFilter* filter = FilterPool().Get(handle);
+    return filter ? filter->WordCount() : 0;
+}
+
+inline bool ImplRandFilterDestroy(int handle) {
+    return FilterPool().Remove(handle);
+}
+
+// Charset for a generating RandFormat pattern character, nullptr for anything else
+inline const char* PatternCharset(char c, uint32_t& radix) {
+    static const char* upper = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    static const char* lower = "abcdefghijklmnopqrstuvwxyz";
+    static const char* digit = "0123456789";
+    static const char* alpha = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    static const char* symbol = "!@#$%^&*()_+-=[]{}|;:,.<>?";
+    
+    switch (c) {
+        case 'X': radix = 26; return upper;
+        case 'x': radix = 26; return lower;
+        case '9': radix = 10; return digit;
+        case 'A': radix = 62; return alpha;
+        case '!': radix = 25; return symbol;
+        default: radix = 0; return nullptr;
+    }
+}
+
+// Compiled RandFormat pattern position
+struct PatternSlot {
+    char literal;         // Emitted when charset is null and check < 0
+    const char* charset;
+    uint32_t radix;
+    int check;            // CheckAlgorithm, or -1
+};
+
+// space is the product of radices, saturated to UINT64_MAX once it exceeds 2^62
+inline void ParsePattern(const char* pattern, std::vector<PatternSlot>& slots, uint64_t& space) {
+    slots.clear();
+    space = 1;
+    int patternLen = static_cast<int>(std::strlen(pattern));
+    
+    for (int i = 0; i < patternLen; i++) {
+        PatternSlot slot = { pattern[i], nullptr, 0, -1 };
+        slot.charset = PatternCharset(pattern[i], slot.radix);
+        
+        if (slot.charset) {
+            space = (space > (1ULL << 62) / slot.radix) ? UINT64_MAX : space * slot.radix;
+        } else if (pattern[i] == '#') {
+            slot.check = static_cast<int>(CheckAlgorithm::Damm);
+        } else if (pattern[i] == '$') {
+            slot.check = static_cast<int>(CheckAlgorithm::Luhn36);
+        } else if (pattern[i] == '\\' && i + 1 < patternLen) {
+            slot.literal = pattern[++i];
+        }
+        slots.push_back(slot);
+    }
+}
+
+// checkSymbols enables the '#' and '$' pattern characters (RandFormatChecked);
+// plain RandFormat copies them literally
+inline bool ImplRandFormat(char* dest, const char* pattern, int destSize, bool checkSymbols = false) {
+    if (destSize <= 0 || dest == nullptr || pattern == nullptr) return false;
+    if (destSize > 65536) return false;
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    auto& rng = Randomix::GetRNG();
+    
+    int outPos = 0;
+    int patternLen = static_cast<int>(std::strlen(pattern));
+    
+    for (int i = 0; i < patternLen && outPos < destSize - 1; i++) {
+        char c = pattern[i];
+        uint32_t radix;
+        const char* charset = PatternCharset(c, radix);
+        
+        if (charset) {
+            dest[outPos++] = charset[rng.next_bounded(radix)];
+            continue;
+        }
+        
+        if (checkSymbols && (c == '#' || c == '$')) {
+            dest[outPos] = ComputeCheckSymbol(dest, outPos, c == '#' ? CheckAlgorithm::Damm : CheckAlgorithm::Luhn36);
+            outPos++;
+        } else if (c == '\\' && i + 1 < patternLen) {
+            i++;
+            dest[outPos++] = pattern[i];
+        } else {
+            dest[outPos++] = c;
+        }
+    }
+    
+    dest[outPos] = '\0';
+    return true;
+}
+
+// RandFormat that never emits a blocked word. Fails if a literal part of
+// the pattern itself is blocked or no clean code turns up after many rewinds.
+inline bool ImplRandFormatFiltered(int filterHandle, char* dest, const char* pattern, int destSize) {
+    BlockFilter* filter = FilterPool().Get(filterHandle);
+    if (filter == nullptr) return false;
+    if (destSize <= 0 || dest == nullptr || pattern == nullptr) return false;
+    
+    std::vector<PatternSlot> slots;
+    uint64_t space;
+    ParsePattern(pattern, slots, space);
+    int len = std::min(static_cast<int>(slots.size()), destSize - 1);
+    
+    FilterScan scan(filter);
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    auto& rng = Randomix::GetRNG();
+    
+    int rewinds = 0;
+    for (int pos = 0; pos < len;) {
+        const PatternSlot& slot = slots[pos];
+        if (slot.charset) {
+            dest[pos] = slot.charset[rng.next_bounded(slot.radix)];
+        } else if (slot.check >= 0) {
+            dest[pos] = ComputeCheckSymbol(dest, pos, static_cast<CheckAlgorithm>(slot.check));
+        } else {
+            dest[pos] = slot.literal;
+        }
+        
+        int start = scan.Push(pos, dest[pos]);
+        if (start < 0) {
+            pos++;
+            continue;
+        }
+        
+        // Regenerate from the first random slot of the match; if the match
+        // has none (literals/check symbols only), from the last one before it
+        int restart = -1;
+        for (int i = start; i <= pos && restart < 0; i++) {
+            if (slots[i].charset) restart = i;
+        }
+        for (int i = start - 1; i >= 0 && restart < 0; i--) {
+            if (slots[i].charset) restart = i;
+        }
+        if (restart < 0 || ++rewinds > 10000) return false;
+        pos = restart;
+    }
+    
+    dest[len] = '\0';
+    return true;
+}
+
+inline bool ImplRandBytes(uint8_t* buffer, int length) {
+    if (length <= 0 || buffer == nullptr) return false;
+    if (length > 65536) return false;
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    
+    for (int i = 0; i < length; i++) {
+        buffer[i] = static_cast<uint8_t>(Randomix::GetRNG().next_uint32() & 0xFF);
+    }
+    return true;
+}
+
+// Token encoders: keystream bits are mapped straight to output symbols,
+// so a token of `bytes` random bytes costs ceil(bytes * 8 / width) symbols
+// and no intermediate byte buffer. Output is unpadded.
+
+enum class TokenEncoding {
+    Base64Url,
+    Base32,
+    Crockford
+};
+
+// Returns encoded length (excluding terminator), 0 on failure or if dest is too small
+// With a filter handle, symbols are scanned as they are emitted and a
+// blocked segment is redrawn; filterHandle 0 disables filtering.
+template<typename CharT>
+inline int ImplRandToken(CharT* dest, int destSize, int bytes, TokenEncoding encoding, int filterHandle = 0) {
+    if (dest == nullptr || bytes <= 0 || bytes > 65536) return 0;
+    
+    BlockFilter* filter = nullptr;
+    if (filterHandle != 0) {
+        filter = FilterPool().Get(filterHandle);
+        if (filter == nullptr) return 0;
+    }
+    
+    static const char* base64url = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    static const char* base32 = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+    static const char* crockford = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+    
+    const char* alphabet;
+    int width;
+    switch (encoding) {
+        case TokenEncoding::Base64Url: alphabet = base64url; width = 6; break;
+        case TokenEncoding::Base32: alphabet = base32; width = 5; break;
+        case TokenEncoding::Crockford: alphabet = crockford; width = 5; break;
+        default: return 0;
+    }
+    
+    int totalBits = bytes * 8;
+    int length = (totalBits + width - 1) / width;
+    if (length >= destSize) return 0;
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    auto& rng = Randomix::GetRNG();
+    
+    uint64_t acc = 0;
+    int accBits = 0;
+    uint32_t mask = (1u << width) - 1;
+    FilterScan scan(filter);
+    int rewinds = 0;
+    
+    for (int i = 0; i < length;) {
+        // Final symbol carries the leftover bits, zero-padded like RFC 4648
+        int take = std::min(width, totalBits - i * width);
+        if (accBits < take) {
+            acc = (acc << 32) | rng.next_uint32();
+            accBits += 32;
+        }
+        accBits -= take;
+        uint32_t value = static_cast<uint32_t>(acc >> accBits) & ((1u << take) - 1);
+        char symbol = alphabet[(value << (width - take)) & mask];
+        dest[i] = static_cast<CharT>(symbol);
+        
+        int start = scan.Push(i, symbol);
+        if (start < 0) {
+            i++;
+        } else {
+            if (++rewinds > 10000) return 0;
+            i = start;
+        }
+    }
+    dest[length] = 0;
+    
+    return length;
+}
+
+inline void FormatUUID(const uint8_t* bytes, char* out) {
+    static const char* hex = "0123456789abcdef";
+    int p = 0;
+    
+    for (int i = 0; i < 16; i++) {
+        out[p++] = hex[bytes[i] >> 4];
+        out[p++] = hex[bytes[i] & 0xF];
+        if (i == 3 || i == 5 || i == 7 || i == 9)
+            out[p++] = '-';
+    }
+    out[p] = '\0';
+}
+
+// Caller must hold rng_mutex
+inline void GenerateUUIDv4(ChaChaRNG& rng, uint8_t* bytes) {
+    rng.next_bytes(bytes, 16);
+    
+    bytes[6] = (bytes[6] & 0x0F) | 0x40;
+    bytes[8] = (bytes[8] & 0x3F) | 0x80;
+}
+
+// UUIDv7 (RFC 9562): 48-bit Unix ms timestamp, 12-bit counter in rand_a
+// (method 1) so ids stay strictly ordered within the same millisecond.
+// Caller must hold rng_mutex
+inline void GenerateUUIDv7(ChaChaRNG& rng, uint8_t* bytes) {
+    static uint64_t lastMs = 0;
+    static uint32_t sequence = 0;
+    
+    uint64_t nowMs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    
+    // Random tail (and fresh counter seed) in one keystream draw
+    rng.next_bytes(bytes + 6, 10);
+    
+    if (nowMs > lastMs) {
+        lastMs = nowMs;
+        // Top counter bit starts clear to leave headroom for increments
+        sequence = (static_cast<uint32_t>(bytes[6]) << 8 | bytes[7]) & 0x7FF;
+    } else if (++sequence > 0xFFF) {
+        // Counter exhausted or clock went backwards: borrow the next ms
+        lastMs++;
+        sequence = 0;
+    }
+    
+    for (int i = 0; i < 6; i++) {
+        bytes[i] = static_cast<uint8_t>(lastMs >> (40 - i * 8));
+    }
+    bytes[6] = static_cast<uint8_t>(0x70 | (sequence >> 8));
+    bytes[7] = static_cast<uint8_t>(sequence);
+    bytes[8] = (bytes[8] & 0x3F) | 0x80;
+}
+
+inline bool ImplRandUUID(char* out) {
+    if (out == nullptr) return false;
+    
+    uint8_t bytes[16];
+    {
+        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+        GenerateUUIDv4(Randomix::GetRNG(), bytes);
+    }
+    
+    FormatUUID(bytes, out);
+    return true;
+}
+
+inline bool ImplRandUUIDv7(char* out) {
+    if (out == nullptr) return false;
+    
+    uint8_t bytes[16];
+    {
+        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+        GenerateUUIDv7(Randomix::GetRNG(), bytes);
+    }
+    
+    FormatUUID(bytes, out);
+    return true;
+}
+
+// Generates `count` UUIDs under a single lock; sink(index, uuidString) stores each one.
+// Returns number generated, 0 on invalid arguments.
+template<typename Sink>
+inline int ImplRandUUIDBulk(int count, int version, Sink&& sink) {
+    if (count <= 0 || count > 65536) return 0;
+    if (version != 4 && version != 7) return 0;
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    auto& rng = Randomix::GetRNG();
+    
+    uint8_t bytes[16];
+    char uuid[37];
+    for (int i = 0; i < count; i++) {
+        if (version == 7) {
+            GenerateUUIDv7(rng, bytes);
+        } else {
+            GenerateUUIDv4(rng, bytes);
+        }
+        FormatUUID(bytes, uuid);
+        sink(i, uuid);
+    }
+    
+    return count;
+}
+
+// RandRegex - uniform generation of strings matching a restricted regex.
+// Supported: literals, escapes (\d \w \s \D \W \S), '.', classes [a-z] and
+// [^...], groups (...) / (?:...), alternation |, and ? * + {n} {n,} {n,m}.
+// Every language is finite: * and + and open {n,} repeat at most
+// REGEX_OPEN_REPEAT extra times. Compilation builds a Thompson NFA, turns it
+// into an (acyclic) DFA and counts accepted strings per state and length,
+// so each string of the language is drawn with equal probability in O(length).
+
+class RegexGenerator {
+public:
+    static constexpr int ALPHABET = 95;   // Printable ASCII 0x20-0x7E
+    static constexpr int MAX_LENGTH = 255;
+    static constexpr int REGEX_OPEN_REPEAT = 8;
+    using CharSet = std::bitset<ALPHABET>;
+    
+private:
+    static constexpr int MAX_NFA_STATES = 20000;
+    static constexpr int MAX_DFA_STATES = 4096;
+    
+    struct Node {
+        enum Type { Set, Concat, Alt, Repeat } type;
+        CharSet set;
+        std::vector<std::unique_ptr<Node>> children;
+        int min = 1, max = 1;
+    };
+    
+    struct NfaState {
+        std::vector<int> epsilon;
+        CharSet set;
+        int target = -1;
+    };
+    
+    struct Edge {
+        int target;
+        std::string chars;
+    };
+    
+    // Parser state
+    const char* p_ = nullptr;
+    bool error_ = false;
+    
+    // Compiled form
+    std::vector<NfaState> nfa_;
+    std::vector<std::vector<Edge>> edges_;
+    std::vector<bool> accept_;
+    std::vector<double> counts_;   // counts_[len * states + state]
+    int maxLength_ = 0;
+    
+    static CharSet Range(char lo, char hi) {
+        CharSet set;
+        for (int c = lo; c <= hi; c++) set.set(c - 0x20);
+        return set;
+    }
+    
+    static bool Printable(char c) { return c >= 0x20 && c <= 0x7E; }
+    
+    // Escape after '\'; returns the set for class escapes or the literal
+    CharSet ParseEscape() {
+        char c = *p_;
+        if (c == '\0') {
+            error_ = true;
+            return CharSet();
+        }
+        p_++;
+        CharSet set;
+        switch (c) {
+            case 'd': return Range('0', '9');
+            case 'D': return ~Range('0', '9');
+            case 'w': return Range('a', 'z') | Range('A', 'Z') | Range('0', '9') | Range('_', '_');
+            case 'W': return ~(Range('a', 'z') | Range('A', 'Z') | Range('0', '9') | Range('_', '_'));
+            case 's': return Range(' ', ' ');
+            case 'S': return ~Range(' ', ' ');
+            default:
+                if (!Printable(c)) error_ = true;
+                else set.set(c - 0x20);
+                return set;
+        }
+    }
+    
+    CharSet ParseClass() {
+        bool negate = (*p_ == '^');
+        if (negate) p_++;
+        
+        CharSet set;
+        bool first = true;
+        while (*p_ && (*p_ != ']' || first)) {
+            first = false;
+            CharSet item;
+            char lo = *p_;
+            if (lo == '\\') {
+                p_++;
+                item = ParseEscape();
+            } else {
+                p_++;
+                if (!Printable(lo)) {
+                    error_ = true;
+                    return set;
+                }
+                if (p_[0] == '-' && p_[1] && p_[1] != ']') {
+                    char hi = p_[1];
+                    if (!Printable(hi) || hi < lo) {
+                        error_ = true;
+                        return set;
+                    }
+                    p_ += 2;
+                    item = Range(lo, hi);
+                } else {
+                    item.set(lo - 0x20);
+                }
+            }
+            set |= item;
+        }
+        if (*p_ != ']') {
+            error_ = true;
+            return set;
+        }
+        p_++;
+        return negate ? ~set : set;
+    }
+    
+    bool ParseNumber(int& out) {
+        if (*p_ < '0' || *p_ > '9') return false;
+        out = 0;
+        while (*p_ >= '0' && *p_ <= '9') {
+            out = out * 10 + (*p_++ - '0');
+            if (out > MAX_LENGTH) return false;
+        }
+        return true;
+    }
+    
+    std::unique_ptr<Node> ParseAtom() {
+        auto node = std::make_unique<Node>();
+        node->type = Node::Set;
+        char c = *p_++;
+        
+        switch (c) {
+            case '(':
+                if (p_[0] == '?' && p_[1] == ':') p_ += 2;
+                node = ParseAlt();
+                if (*p_ != ')') error_ = true;
+                else p_++;
+                return node;
+            case '[':
+                node->set = ParseClass();
+                return node;
+            case '.':
+                node->set.set();
+                return node;
+            case '\\':
+                node->set = ParseEscape();
+                return node;
+            case '*': case '+': case '?': case '{': case ')': case '|':
+                error_ = true;
+                return node;
+            default:
+                if (!Printable(c)) error_ = true;
+                else node->set.set(c - 0x20);
+                return node;
+        }
+    }
+    
+    std::unique_ptr<Node> ParseRepeat() {
+        auto atom = ParseAtom();
+        while (!error_ && (*p_ == '?' || *p_ == '*' || *p_ == '+' || *p_ == '{')) {
+            int min, max;
+            char q = *p_++;
+            if (q == '?') { min = 0; max = 1; }
+            else if (q == '*') { min = 0; max = REGEX_OPEN_REPEAT; }
+            else if (q == '+') { min = 1; max = 1 + REGEX_OPEN_REPEAT; }
+            else {
+                if (!ParseNumber(min)) { error_ = true; break; }
+                max = min;
+                if (*p_ == ',') {
+                    p_++;
+                    if (*p_ == '}') max = min + REGEX_OPEN_REPEAT;
+                    else if (!ParseNumber(max) || max < min) { error_ = true; break; }
+                }
+                if (*p_ != '}') { error_ = true; break; }
+                p_++;
+            }
+            auto repeat = std::make_unique<Node>();
+            repeat->type = Node::Repeat;
+            repeat->min = min;
+            repeat->max = max;
+            repeat->children.push_back(std::move(atom));
+            atom = std::move(repeat);
+        }
+        return atom;
+    }
+    
+    std::unique_ptr<Node> ParseConcat() {
+        auto node = std::make_unique<Node>();
+        node->type = Node::Concat;
+        while (!error_ && *p_ && *p_ != '|' && *p_ != ')') {
+            node->children.push_back(ParseRepeat());
+        }
+        return node;
+    }
+    
+    std::unique_ptr<Node> ParseAlt() {
+        auto node = std::make_unique<Node>();
+        node->type = Node::Alt;
+        node->children.push_back(ParseConcat());
+        while (!error_ && *p_ == '|') {
+            p_++;
+            node->children.push_back(ParseConcat());
+        }
+        return node;
+    }
+    
+    int NewState() {
+        if (static_cast<int>(nfa_.size()) >= MAX_NFA_STATES) {
+            error_ = true;
+            return 0;
+        }
+        nfa_.emplace_back();
+        return static_cast<int>(nfa_.size()) - 1;
+    }
+    
+    // Thompson construction; returns the end state of a fragment starting at `start`
+    int Build(const Node& node, int start) {
+        if (error_) return start;
+        
+        switch (node.type) {
+            case Node::Set: {
+                int end = NewState();
+                if (error_) return start;
+                nfa_[start].set = node.set;
+                nfa_[start].target = end;
+                return end;
+            }
+            case Node::Concat: {
+                int cur = start;
+                for (const auto& child : node.children) {
+                    cur = Build(*child, cur);
+                }
+                return cur;
+            }
+            case Node::Alt: {
+                int end = NewState();
+                for (const auto& child : node.children) {
+                    int branch = NewState();
+                    if (error_) return start;
+                    nfa_[start].epsilon.push_back(branch);
+                    int branchEnd = Build(*child, branch);
+                    if (error_) return start;
+                    nfa_[branchEnd].epsilon.push_back(end);
+                }
+                return end;
+            }
+            case Node::Repeat: {
+                int cur = start;
+                for (int i = 0; i < node.min && !error_; i++) {
+                    cur = Build(*node.children[0], cur);
+                }
+                // Optional copies all jump to the shared end
+                int end = NewState();
+                for (int i = node.min; i < node.max && !error_; i++) {
+                    nfa_[cur].epsilon.push_back(end);
+                    cur = Build(*node.children[0], cur);
+                }
+                if (!error_) nfa_[cur].epsilon.push_back(end);
+                return end;
+            }
+        }
+        return start;
+    }
+    
+    void Closure(std::vector<int>& states) const {
+        std::vector<bool> seen(nfa_.size(), false);
+        for (int s : states) seen[s] = true;
+        for (size_t i = 0; i < states.size(); i++) {
+            for (int next : nfa_[states[i]].epsilon) {
+                if (!seen[next]) {
+                    seen[next] = true;
+                    states.push_back(next);
+                }
+            }
+        }
+        std::sort(states.begin(), states.end());
+    }
+    
+    bool Determinize(int nfaStart, int nfaAccept) {
+        std::map<std::vector<int>, int> ids;
+        std::vector<std::vector<int>> sets;
+        
+        std::vector<int> initial = { nfaStart };
+        Closure(initial);
+        ids[initial] = 0;
+        sets.push_back(initial);
+        
+        for (size_t d = 0; d < sets.size(); d++) {
+            std::vector<int> current = sets[d];
+            bool accepting = std::binary_search(current.begin(), current.end(), nfaAccept);
+            
+            std::vector<int> target(ALPHABET, -1);
+            for (int c = 0; c < ALPHABET; c++) {
+                std::vector<int> moved;
+                for (int s : current) {
+                    if (nfa_[s].target >= 0 && nfa_[s].set.test(c)) moved.push_back(nfa_[s].target);
+                }
+                if (moved.empty()) continue;
+                Closure(moved);
+                moved.erase(std::unique(moved.begin(), moved.end()), moved.end());
+                
+                auto it = ids.find(moved);
+                if (it == ids.end()) {
+                    if (static_cast<int>(sets.size()) >= MAX_DFA_STATES) return false;
+                    it = ids.emplace(moved, static_cast<int>(sets.size())).first;
+                    sets.push_back(moved);
+                }
+                target[c] = it->second;
+            }
+            
+            // Group characters by target so generation is O(edges) per step
+            std::vector<Edge> edges;
+            for (int c = 0; c < ALPHABET; c++) {
+                if (target[c] < 0) continue;
+                auto e = std::find_if(edges.begin(), edges.end(), [&](const Edge& x) { return x.target == target[c]; });
+                if (e == edges.end()) {
+                    edges.push_back({ target[c], std::string() });
+                    e = edges.end() - 1;
+                }
+                e->chars += static_cast<char>(c + 0x20);
+            }
+            edges_.push_back(std::move(edges));
+            accept_.push_back(accepting);
+        }
+        return true;
+    }
+    
+    bool Count() {
+        int states = static_cast<int>(edges_.size());
+        
+        // Longest accepted string via DFS order on the acyclic DFA
+        std::vector<int> longest(states, -2);   // -2 = unvisited, -1 = dead
+        std::vector<std::pair<int, size_t>> stack = { { 0, 0 } };
+        std::vector<bool> onStack(states, false);
+        onStack[0] = true;
+        while (!stack.empty()) {
+            auto& top = stack.back();
+            int s = top.first;
+            if (top.second < edges_[s].size()) {
+                int t = edges_[s][top.second++].target;
+                if (onStack[t]) return false;   // Cycle: cannot happen with bounded repeats
+                if (longest[t] == -2) {
+                    onStack[t] = true;
+                    stack.push_back({ t, 0 });
+                }
+                continue;
+            }
+            int best = accept_[s] ? 0 : -1;
+            for (const auto& e : edges_[s]) {
+                if (longest[e.target] >= 0) best = std::max(best, longest[e.target] + 1);
+            }
+            longest[s] = best;
+            onStack[s] = false;
+            stack.pop_back();
+        }
+        if (longest[0] < 0 || longest[0] > MAX_LENGTH) return false;
+        maxLength_ = longest[0];
+        
+        counts_.assign(static_cast<size_t>(maxLength_ + 1) * states, 0.0);
+        for (int s = 0; s < states; s++) {
+            counts_[s] = accept_[s] ? 1.0 : 0.0;
+        }
+        for (int len = 1; len <= maxLength_; len++) {
+            for (int s = 0; s < states; s++) {
+                double total = 0.0;
+                for (const auto& e : edges_[s]) {
+                    total += static_cast<double>(e.chars.size()) * counts_[static_cast<size_t>(len - 1) * states + e.target];
+                }
+                counts_[static_cast<size_t>(len) * states + s] = total;
+            }
+        }
+        
+        // Uniform draws need finite counts: every entry is bounded by the
+        // total over all lengths from the start state, so checking that suffices
+        double all = 0.0;
+        for (int len = 0; len <= maxLength_; len++) all += counts_[static_cast<size_t>(len) * states];
+        return std::isfinite(all);
+    }
+    
+public:
+    bool Compile(const char* pattern) {
+        p_ = pattern;
+        error_ = false;
+        
+        // Anchors are implicit: the whole string always matches
+        if (*p_ == '^') p_++;
+        size_t len = std::strlen(p_);
+        std::string body(p_, len);
+        if (len > 0 && body[len - 1] == '$' && (len < 2 || body[len - 2] != '\\')) body.pop_back();
+        p_ = body.c_str();
+        
+        auto root = ParseAlt();
+        if (error_ || *p_ != '\0') return false;
+        
+        int start = NewState();
+        int accept = Build(*root, start);
+        if (error_) return false;
+        
+        bool ok = Determinize(start, accept) && Count();
+        nfa_.clear();
+        nfa_.shrink_to_fit();
+        return ok;
+    }
+    
+    int MaxLength() const { return maxLength_; }
+    
+    // Caller must hold rng_mutex. Returns generated length, -1 if no string fits.
+    template<typename CharT>
+    int Generate(ChaChaRNG& rng, CharT* dest, int destSize) const {
+        int states = static_cast<int>(edges_.size());
+        int limit = std::min(maxLength_, destSize - 1);
+        if (limit < 0) return -1;
+        
+        double total = 0.0;
+        for (int len = 0; len <= limit; len++) total += counts_[static_cast<size_t>(len) * states];
+        if (total <= 0.0) return -1;
+        
+        // Pick the length in proportion to how many strings have it
+        double r = NextUnitDouble(rng) * total;
+        int length = 0;
+        for (; length < limit; length++) {
+            double c = counts_[static_cast<size_t>(length) * states];
+            if (r < c) break;
+            r -= c;
+        }
+        while (counts_[static_cast<size_t>(length) * states] <= 0.0) length--;
+        
+        int state = 0;
+        for (int pos = 0; pos < length; pos++) {
+            size_t row = static_cast<size_t>(length - pos - 1) * states;
+            double weight = 0.0;
+            for (const auto& e : edges_[state]) {
+                weight += static_cast<double>(e.chars.size()) * counts_[row + e.target];
+            }
+            
+            double pick = NextUnitDouble(rng) * weight;
+            const Edge* chosen = nullptr;
+            for (const auto& e : edges_[state]) {
+                double w = static_cast<double>(e.chars.size()) * counts_[row + e.target];
+                if (w <= 0.0) continue;
+                chosen = &e;
+                if (pick < w) break;
+                pick -= w;
+            }
+            
+            dest[pos] = static_cast<CharT>(chosen->chars[rng.next_bounded(static_cast<uint32_t>(chosen->chars.size()))]);
+            state = chosen->target;
+        }
+        dest[length] = 0;
+        return length;
+    }
+};
+
+inline HandlePool<RegexGenerator>& RegexPool() {
+    static HandlePool<RegexGenerator> pool;
+    return pool;
+}
+
+inline int ImplRandRegexCompile(const char* pattern) {
+    if (pattern == nullptr) return 0;
+    
+    auto regex = std::make_unique<RegexGenerator>();
+    if (!regex->Compile(pattern)) return 0;
+    return RegexPool().Add(std::move(regex));
+}
+
+// Returns generated length, -1 on invalid handle or if dest is too small
+template<typename CharT>
+inline int ImplRandRegex(int handle, CharT* dest, int destSize) {
+    RegexGenerator* regex = RegexPool().Get(handle);
+    if (regex == nullptr || dest == nullptr || destSize <= 0) return -1;
+    
+    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+    return regex->Generate(Randomix::GetRNG(), dest, destSize);
+}
+
+inline int ImplRandRegexMaxLength(int handle) {
+    RegexGenerator* regex = RegexPool().Get(handle);
+    return regex ? regex->MaxLength() : -1;
+}
+
+inline bool ImplRandRegexDestroy(int handle) {
+    return RegexPool().Remove(handle);
+}
+
+// RandMarkov - order-k character Markov name generator. Names are trained
+// lowercase; each context (last k characters) becomes a state with an alias
+// table over its successors and precomputed successor states, so a name is
+// one indexed walk with no hashing.
+
+class MarkovModel {
+private:
+    static constexpr char BOUNDARY = '\0';   // Start padding and end-of-name
+    
+    struct State {
+        std::string symbols;               // Successor characters (BOUNDARY = end)
+        std::vector<int32_t> next;         // Successor state per symbol, -1 for end
+        AliasTable table;
+    };
+    
+    int order_;
+    bool dirty_ = true;
+    std::unordered_map<std::string, std::map<char, uint32_t>> counts_;
+    std::unordered_map<std::string, int32_t> index_;
+    std::vector<State> states_;
+    std::vector<std::string> names_;   // For rejecting verbatim copies
+    
+    static char Fold(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+    
+    void Compile() {
+        index_.clear();
+        states_.clear();
+        for (const auto& entry : counts_) {
+            index_.emplace(entry.first, static_cast<int32_t>(states_.size()));
+            states_.emplace_back();
+        }
+        for (const auto& entry : counts_) {
+            State& state = states_[index_[entry.first]];
+            std::vector<double> weights;
+            for (const auto& succ : entry.second) {
+                state.symbols += succ.first;
+                weights.push_back(static_cast<double>(succ.second));
+                if (succ.first == BOUNDARY) {
+                    state.next.push_back(-1);
+                } else {
+                    auto it = index_.find(entry.first.substr(1) + succ.first);
+                    state.next.push_back(it != index_.end() ? it->second : -1);
+                }
+            }
+            state.table.Build(weights);
+        }
+        std::sort(names_.begin(), names_.end());
+        dirty_ = false;
+    }
+    
+public:
+    explicit MarkovModel(int order) : order_(order) {}
+    
+    bool Train(const char* name) {
+        std::string folded;
+        for (const char* p = name; *p; p++) {
+            if (static_cast<unsigned char>(*p) < 0x20) continue;
+            folded += Fold(*p);
+        }
+        if (folded.empty() || folded.size() > 64) return false;
+        
+        std::string context(order_, BOUNDARY);
+        for (char c : folded) {
+            counts_[context][c]++;
+            context = context.substr(1) + c;
+        }
+        counts_[context][BOUNDARY]++;
+        names_.push_back(folded);
+        dirty_ = true;
+        return true;
+    }
+    
+    int NameCount() const { return static_cast<int>(names_.size()); }
+    
+    // Returns name length, -1 if no name satisfied the constraints
+    template<typename CharT>
+    int Generate(CharT* dest, int destSize, int minLen, int maxLen, const char* prefix, bool allowCopies) {
+        if (dirty_) Compile();
+        if (states_.empty()) return -1;
+        
+        maxLen = std::min(maxLen, destSize - 1);
+        if (minLen < 1) minLen = 1;
+        if (maxLen < minLen) return -1;
+        
+        // Walk the prefix deterministically
+        auto start = index_.find(std::string(order_, BOUNDARY));
+        if (start == index_.end()) return -1;
+        int32_t prefixState = start->second;
+        std::string prefixText;
+        for (const char* p = prefix; *p; p++) {
+            char c = Fold(*p);
+            const State& state = states_[prefixState];
+            size_t at = state.symbols.find(c);
+            if (at == std::string::npos || state.next[at] < 0) return -1;
+            prefixText += c;
+            prefixState = state.next[at];
+        }
+        if (static_cast<int>(prefixText.size()) > maxLen) return -1;
+        
+        std::string name;
+        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+        auto& rng = Randomix::GetRNG();
+        
+        for (int attempt = 0; attempt < 1000; attempt++) {
+            name = prefixText;
+            int32_t current = prefixState;
+            bool ended = false;
+            
+            while (static_cast<int>(name.size()) <= maxLen) {
+                const State& state = states_[current];
+                uint32_t pick = state.table.Sample(rng);
+                if (state.symbols[pick] == BOUNDARY) {
+                    ended = true;
+                    break;
+                }
+                name += state.symbols[pick];
+                current = state.next[pick];
+                if (current < 0) break;
+            }
+            
+            int len = static_cast<int>(name.size());
+            if (!ended || len < minLen || len > maxLen) continue;
+            if (!allowCopies && std::binary_search(names_.begin(), names_.end(), name)) continue;
+            
+            for (int i = 0; i < len; i++) {
+                char c = name[i];
+                if (i == 0 && c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+                dest[i] = static_cast<CharT>(c);
+            }
+            dest[len] = 0;
+            return len;
+        }
+        return -1;
+    }
+};
+
+inline HandlePool<MarkovModel>& MarkovPool() {
+    static HandlePool<MarkovModel> pool;
+    return pool;
+}
+
+inline int ImplRandMarkovCreate(int order) {
+    if (order < 1 || order > 6) return 0;
+    return MarkovPool().Add(std::make_unique<MarkovModel>(order));
+}
+
+inline bool ImplRandMarkovTrain(int handle, const char* name) {
+    MarkovModel* model = MarkovPool().Get(handle);
+    if (model == nullptr || name == nullptr) return false;
+    return model->Train(name);
+}
+
+// One name per line under scriptfiles/; lines starting with ';' are skipped
+inline int ImplRandMarkovLoad(const char* filename, int order) {
+    std::string path;
+    if (order < 1 || order > 6 || !ScriptFilePath(filename, path)) return 0;
+    
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return 0;
+    
+    auto model = std::make_unique<MarkovModel>(order);
+    char line[256];
+    while (std::fgets(line, sizeof(line), f)) {
+        line[std::strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == ';') continue;
+        model->Train(line);
+    }
+    std::fclose(f);
+    
+    if (model->NameCount() == 0) return 0;
+    return MarkovPool().Add(std::move(model));
+}
+
+template<typename CharT>
+inline int ImplRandMarkovName(int handle, CharT* dest, int destSize, int minLen, int maxLen, const char* prefix, bool allowCopies) {
+    MarkovModel* model = MarkovPool().Get(handle);
+    if (model == nullptr || dest == nullptr || destSize <= 1 || prefix == nullptr) return -1;
+    return model->Generate(dest, destSize, minLen, maxLen, prefix, allowCopies);
+}
+
+inline int ImplRandMarkovNameCount(int handle) {
+    MarkovModel* model = MarkovPool().Get(handle);
+    return model ? model->NameCount() : 0;
+}
+
+inline bool ImplRandMarkovDestroy(int handle) {
+    return MarkovPool().Remove(handle);
+}
+
+// RandPassphrase - diceware-style phrases. Each wordlist is memory-mapped on
+// first use and indexed once; words are read straight from the mapping.
+
+struct PassphraseWordlist {
+    MappedFile file;
+    std::vector<uint32_t> offsets;
+    std::vector<uint8_t> lengths;
+};
+
+inline PassphraseWordlist* GetPassphraseWordlist(const char* filename) {
+    static std::map<std::string, std::unique_ptr<PassphraseWordlist>> cache;
+    
+    std::string path;
+    if (!ScriptFilePath(filename, path)) return nullptr;
+    
+    auto it = cache.find(path);
+    if (it != cache.end()) return it->second.get();
+    
+    auto list = std::make_unique<PassphraseWordlist>();
+    if (!list->file.open(path.c_str())) return nullptr;
+    
+    // Lines are "word" or EFF-style "11111<tab>word"; ';' starts a comment
+    const char* data = list->file.data();
+    size_t size = list->file.size();
+    size_t pos = 0;
+    while (pos < size && pos < 0xFFFFFFFFu) {
+        size_t end = pos;
+        while (end < size && data[end] != '\n') end++;
+        
+        size_t start = pos;
+        size_t stop = end;
+        while (stop > start && (data[stop - 1] == '\r' || data[stop - 1] == ' ' || data[stop - 1] == '\t')) stop--;
+        
+        size_t digits = start;
+        while (digits < stop && data[digits] >= '0' && data[digits] <= '9') digits++;
+        if (digits > start && digits < stop && (data[digits] == '\t' || data[digits] == ' ')) {
+            start = digits;
+            while (start < stop && (data[start] == '\t' || data[start] == ' ')) start++;
+        }
+        
+        size_t len = stop - start;
+        if (len > 0 && len <= 32 && data[start] != ';') {
+            list->offsets.push_back(static_cast<uint32_t>(start));
+            list->lengths.push_back(static_cast<uint8_t>(len));
+        }
+        pos = end + 1;
+    }
+    
+    if (list->offsets.size() < 2) return nullptr;
+    
+    PassphraseWordlist* result = list.get();
+    cache.emplace(path, std::move(list));
+    return result;
+}
+
+// Returns phrase length, -1 on failure
+template<typename CharT>
+inline int ImplRandPassphrase(CharT* dest, int destSize, int words, const char* separator, const char* wordlist) {
+    if (dest == nullptr || destSize <= 1 || separator == nullptr) return -1;
+    if (words < 1 || words > 32) return -1;
+    
+    PassphraseWordlist* list = GetPassphraseWordlist(wordlist);
+    if (list == nullptr) return -1;
+    
+    uint32_t picks[32];
+    {
+        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+        auto& rng = Randomix::GetRNG();
+        uint32_t count = static_cast<uint32_t>(list->offsets.size());
+        for (int i = 0; i < words; i++) {
+            picks[i] = rng.next_bounded(count);
+        }
+    }
+    
+    size_t sepLen = std::strlen(separator);
+    const char* data = list->file.data();
+    int pos = 0;
+    for (int i = 0; i < words; i++) {
+        if (i > 0) {
+            if (pos + static_cast<int>(sepLen) >= destSize) return -1;
+            for (size_t j = 0; j < sepLen; j++) {
+                dest[pos++] = static_cast<CharT>(separator[j]);
+            }
+        }
+        
+        const char* word = data + list->offsets[picks[i]];
+        int len = list->lengths[picks[i]];
+        if (pos + len >= destSize) return -1;
+        for (int j = 0; j < len; j++) {
+            dest[pos++] = static_cast<CharT>(static_cast<unsigned char>(word[j]));
+        }
+    }
+    dest[pos] = 0;
+    return pos;
+}
+
+inline int ImplRandPassphraseWordCount(const char* wordlist) {
+    PassphraseWordlist* list = GetPassphraseWordlist(wordlist);
+    return list ? static_cast<int>(list->offsets.size()) : 0;
+}
+
+// RandDeck - shuffle bags. Cards [0, remaining) are undrawn; a draw swaps a
+// random undrawn card to the boundary (one Fisher-Yates step), so reshuffling
+// is just resetting the boundary.
+
+class Deck {
+private:
+    std::vector<int32_t> cards_;
+    size_t remaining_;
+    bool autoReshuffle_;
+    
+public:
+    Deck(const int32_t* values, size_t count, bool autoReshuffle)
+        : cards_(values, values + count), remaining_(count), autoReshuffle_(autoReshuffle) {}
+    
+    bool Draw(int32_t& out) {
+        if (remaining_ == 0) {
+            if (!autoReshuffle_) return false;
+            remaining_ = cards_.size();
+        }
+        
+        uint32_t j;
+        {
+            std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+            j = Randomix::GetRNG().next_bounded(static_cast<uint32_t>(remaining_));
+        }
+        remaining_--;
+        std::swap(cards_[j], cards_[remaining_]);
+        out = cards_[remaining_];
+        return true;
+    }
+    
+    // Put one drawn copy of value back into the undrawn part
+    bool Return(int32_t value) {
+        for (size_t i = remaining_; i < cards_.size(); i++) {
+            if (cards_[i] == value) {
+                std::swap(cards_[i], cards_[remaining_]);
+                remaining_++;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    void Reshuffle() { remaining_ = cards_.size(); }
+    int Remaining() const { return static_cast<int>(remaining_); }
+    int Size() const { return static_cast<int>(cards_.size()); }
+};
+
+inline HandlePool<Deck>& DeckPool() {
+    static HandlePool<Deck> pool;
+    return pool;
+}
+
+inline int ImplRandDeckCreate(const int32_t* values, int count, bool autoReshuffle) {
+    if (values == nullptr || count <= 0 || count > 10000000) return 0;
+    return DeckPool().Add(std::make_unique<Deck>(values, static_cast<size_t>(count), autoReshuffle));
+}
+
+inline bool ImplRandDeckDraw(int handle, int32_t& out) {
+    Deck* deck = DeckPool().Get(handle);
+    return deck != nullptr && deck->Draw(out);
+}
+
+inline bool ImplRandDeckReturn(int handle, int32_t value) {
+    Deck* deck = DeckPool().Get(handle);
+    return deck != nullptr && deck->Return(value);
+}
+
+inline bool ImplRandDeckReshuffle(int handle) {
+    Deck* deck = DeckPool().Get(handle);
+    if (deck == nullptr) return false;
+    deck->Reshuffle();
+    return true;
+}
+
+inline int ImplRandDeckRemaining(int handle) {
+    Deck* deck = DeckPool().Get(handle);
+    return deck ? deck->Remaining() : 0;
+}
+
+inline int ImplRandDeckSize(int handle) {
+    Deck* deck = DeckPool().Get(handle);
+    return deck ? deck->Size() : 0;
+}
+
+inline bool ImplRandDeckDestroy(int handle) {
+    return DeckPool().Remove(handle);
+}
+
+// RandUniqueRange - distinct integers from [min, max] via sparse Fisher-Yates.
+// The virtual array slot i holds i unless remapped; only touched slots are
+// stored, so memory is O(draws) regardless of the range size.
+
+class UniqueRange {
+private:
+    int64_t min_;
+    uint32_t size_;
+    uint32_t drawn_ = 0;
+    std::unordered_map<uint32_t, uint32_t> remap_;
+    
+    uint32_t SlotValue(uint32_t slot) const {
+        auto it = remap_.find(slot);
+        return it != remap_.end() ? it->second : slot;
+    }
+    
+public:
+    UniqueRange(int64_t min, uint32_t size) : min_(min), size_(size) {}
+    
+    bool Next(int32_t& out) {
+        if (drawn_ >= size_) return false;
+        
+        uint32_t j;
+        {
+            std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+            j = drawn_ + Randomix::GetRNG().next_bounded(size_ - drawn_);
+        }
+        uint32_t picked = SlotValue(j);
+        if (j != drawn_) remap_[j] = SlotValue(drawn_);
+        remap_.erase(drawn_);
+        drawn_++;
+        
+        out = static_cast<int32_t>(min_ + picked);
+        return true;
+    }
+    
+    void Reset() {
+        remap_.clear();
+        drawn_ = 0;
+    }
+    
+    uint32_t Remaining() const { return size_ - drawn_; }
+};
+
+inline HandlePool<UniqueRange>& UniqueRangePool() {
+    static HandlePool<UniqueRange> pool;
+    return pool;
+}
+
+inline int ImplRandUniqueRangeCreate(int min, int max) {
+    if (min > max) std::swap(min, max);
+    int64_t span = static_cast<int64_t>(max) - min + 1;
+    if (span > 0xFFFFFFFFLL) return 0;
+    return UniqueRangePool().Add(std::make_unique<UniqueRange>(min, static_cast<uint32_t>(span)));
+}
+
+inline bool ImplRandUniqueNext(int handle, int32_t& out) {
+    UniqueRange* range = UniqueRangePool().Get(handle);
+    return range != nullptr && range->Next(out);
+}
+
+inline int ImplRandUniqueRangeRemaining(int handle) {
+    UniqueRange* range = UniqueRangePool().Get(handle);
+    if (range == nullptr) return 0;
+    return static_cast<int>(std::min<uint32_t>(range->Remaining(), 0x7FFFFFFF));
+}
+
+inline bool ImplRandUniqueRangeReset(int handle) {
+    UniqueRange* range = UniqueRangePool().Get(handle);
+    if (range == nullptr) return false;
+    range->Reset();
+    return true;
+}
+
+inline bool ImplRandUniqueRangeDestroy(int handle) {
+    return UniqueRangePool().Remove(handle);
+}
+
+// Exclusion-aware ranges. A draw picks a rank among the allowed values and
+// maps it back to a value, so there are no retries.
+
+// Random value in [min, max) not in excluded; returns min if nothing is left
+inline int ImplRandRangeExcluding(int min, int max, const int32_t* excluded, int count) {
+    if (min > max) std::swap(min, max);
+    if (min == max) return min;
+    
+    std::vector<int64_t> sorted;
+    if (excluded != nullptr && count > 0) {
+        sorted.reserve(static_cast<size_t>(count));
+        for (int i = 0; i < count; i++) {
+            if (excluded[i] >= min && excluded[i] < max) sorted.push_back(excluded[i]);
+        }
+        std::sort(sorted.begin(), sorted.end());
+        sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    }
+    
+    int64_t available = static_cast<int64_t>(max) - min - static_cast<int64_t>(sorted.size());
+    if (available <= 0) return min;
+    
+    int64_t rank;
+    {
+        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+        rank = Randomix::GetRNG().next_bounded(static_cast<uint32_t>(available));
+    }
+    
+    // sorted[i] - min - i allowed values lie below sorted[i]; skip every
+    // excluded value whose count is <= rank (binary search, O(log k))
+    size_t lo = 0, hi = sorted.size();
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (sorted[mid] - min - static_cast<int64_t>(mid) <= rank) lo = mid + 1;
+        else hi = mid;
+    }
+    return static_cast<int>(min + rank + static_cast<int64_t>(lo));
+}
+
+// Integer set over [min, max) stored as disjoint allowed intervals. Edits
+// are O(log k) map operations; picks use a lazily rebuilt prefix-count array
+// and a binary search, O(log k).
+class IntervalSet {
+private:
+    int64_t min_, max_;
+    std::map<int64_t, int64_t> intervals_;   // start -> end (exclusive)
+    bool dirty_ = true;
+    std::vector<int64_t> starts_;
+    std::vector<int64_t> prefix_;            // Allowed values before interval i
+    int64_t total_ = 0;
+    
+    void Rebuild() {
+        starts_.clear();
+        prefix_.clear();
+        total_ = 0;
+        for (const auto& iv : intervals_) {
+            starts_.push_back(iv.first);
+            prefix_.push_back(total_);
+            total_ += iv.second - iv.first;
+        }
+        dirty_ = false;
+    }
+    
+public:
+    IntervalSet(int64_t min, int64_t max) : min_(min), max_(max) {
+        intervals_[min] = max;
+    }
+    
+    void Include(int64_t a, int64_t b) {
+        a = std::max(a, min_);
+        b = std::min(b, max_);
+        if (a >= b) return;
+        
+        auto it = intervals_.upper_bound(a);
+        if (it != intervals_.begin()) {
+            auto prev = std::prev(it);
+            if (prev->second >= a) {
+                a = prev->first;
+                b = std::max(b, prev->second);
+                intervals_.erase(prev);
+            }
+        }
+        while (it != intervals_.end() && it->first <= b) {
+            b = std::max(b, it->second);
+            it = intervals_.erase(it);
+        }
+        intervals_[a] = b;
+        dirty_ = true;
+    }
+    
+    void Exclude(int64_t a, int64_t b) {
+        a = std::max(a, min_);
+        b = std::min(b, max_);
+        if (a >= b) return;
+        
+        auto it = intervals_.upper_bound(a);
+        if (it != intervals_.begin()) {
+            auto prev = std::prev(it);
+            if (prev->second > a) {
+                int64_t end = prev->second;
+                if (prev->first == a) intervals_.erase(prev);
+                else prev->second = a;
+                if (end > b) intervals_[b] = end;
+            }
+        }
+        while (it != intervals_.end() && it->first < b) {
+            if (it->second > b) {
+                int64_t end = it->second;
+                intervals_.erase(it);
+                intervals_[b] = end;
+                break;
+            }
+            it = intervals_.erase(it);
+        }
+        dirty_ = true;
+    }
+    
+    bool Contains(int64_t v) const {
+        auto it = intervals_.upper_bound(v);
+        if (it == intervals_.begin()) return false;
+        return std::prev(it)->second > v;
+    }
+    
+    int64_t Count() {
+        if (dirty_) Rebuild();
+        return total_;
+    }
+    
+    bool Pick(int32_t& out) {
+        if (dirty_) Rebuild();
+        if (total_ <= 0) return false;
+        
+        int64_t rank;
+        {
+            std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+            rank = Randomix::GetRNG().next_bounded(static_cast<uint32_t>(total_));
+        }
+        size_t i = static_cast<size_t>(std::upper_bound(prefix_.begin(), prefix_.end(), rank) - prefix_.begin()) - 1;
+        out = static_cast<int32_t>(starts_[i] + (rank - prefix_[i]));
+        return true;
+    }
+};
+
+inline HandlePool<IntervalSet>& IntervalSetPool() {
+    static HandlePool<IntervalSet> pool;
+    return pool;
+}
+
+inline int ImplRandIntSetCreate(int min, int max) {
+    if (min > max) std::swap(min, max);
+    if (min == max) return 0;
+    return IntervalSetPool().Add(std::make_unique<IntervalSet>(min, max));
+}
+
+inline bool ImplRandIntSetExclude(int handle, int from, int to) {
+    IntervalSet* set = IntervalSetPool().Get(handle);
+    if (set == nullptr) return false;
+    if (from > to) std::swap(from, to);
+    set->Exclude(from, to);
+    return true;
+}
+
+inline bool ImplRandIntSetInclude(int handle, int from, int to) {
+    IntervalSet* set = IntervalSetPool().Get(handle);
+    if (set == nullptr) return false;
+    if (from > to) std::swap(from, to);
+    set->Include(from, to);
+    return true;
+}
+
+inline bool ImplRandIntSetContains(int handle, int value) {
+    IntervalSet* set = IntervalSetPool().Get(handle);
+    return set != nullptr && set->Contains(value);
+}
+
+inline int ImplRandIntSetCount(int handle) {
+    IntervalSet* set = IntervalSetPool().Get(handle);
+    if (set == nullptr) return 0;
+    return static_cast<int>(std::min<int64_t>(set->Count(), 0x7FFFFFFF));
+}
+
+inline bool ImplRandIntSetPick(int handle, int32_t& out) {
+    IntervalSet* set = IntervalSetPool().Get(handle);
+    return set != nullptr && set->Pick(out);
+}
+
+inline bool ImplRandIntSetDestroy(int handle) {
+    return IntervalSetPool().Remove(handle);
+}
+
+// Time-sliced shuffles - Fisher-Yates run a budgeted chunk per server tick.
+// The loop walks the cursor downwards, so every position above it already
+// holds its final value. Finished jobs queue OnRandShuffleDone(handle) for
+// the owning script and free their handle once that callback has run.
+
+class SlicedShuffle {
+private:
+    void* owner_;
+    int32_t* array_;
+    int64_t cursor_;     // Next position to finalize
+    int64_t count_;
+    int budgetMicros_;
+    
+public:
+    SlicedShuffle(void* owner, int32_t* array, int count, int budgetMicros)
+        : owner_(owner), array_(array), cursor_(count - 1), count_(count), budgetMicros_(budgetMicros) {}
+    
+    void* Owner() const { return owner_; }
+    
+    // Returns true once the whole array is shuffled
+    bool Step() {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(budgetMicros_);
+        
+        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+        auto& rng = Randomix::GetRNG();
+        while (cursor_ > 0) {
+            int64_t stop = std::max<int64_t>(0, cursor_ - 4096);
+            for (; cursor_ > stop; cursor_--) {
+                uint32_t j = rng.next_bounded(static_cast<uint32_t>(cursor_ + 1));
+                std::swap(array_[cursor_], array_[j]);
+            }
+            if (std::chrono::steady_clock::now() >= deadline) break;
+        }
+        return cursor_ <= 0;
+    }
+    
+    // Percentage of positions finalized
+    int Progress() const {
+        if (count_ <= 1) return 100;
+        return static_cast<int>((count_ - 1 - cursor_) * 100 / (count_ - 1));
+    }
+};
+
+inline HandlePool<SlicedShuffle>& SlicedShufflePool() {
+    static HandlePool<SlicedShuffle> pool;
+    return pool;
+}
+
+// Live job handles, in start order
+inline std::vector<int>& SlicedShuffleJobs() {
+    static std::vector<int> jobs;
+    return jobs;
+}
+
+// `array` must outlive the job (global or static Pawn data)
+inline int ImplRandShuffleBegin(void* owner, int32_t* array, int count, int budgetMicros) {
+    if (array == nullptr || count <= 0) return 0;
+    if (budgetMicros < 50) budgetMicros = 50;
+    if (budgetMicros > 100000) budgetMicros = 100000;
+    
+    int handle = SlicedShufflePool().Add(std::make_unique<SlicedShuffle>(owner, array, count, budgetMicros));
+    if (handle) SlicedShuffleJobs().push_back(handle);
+    return handle;
+}
+
+inline int ImplRandShuffleProgress(int handle) {
+    SlicedShuffle* job = SlicedShufflePool().Get(handle);
+    return job ? job->Progress() : -1;
+}
+
+inline bool ImplRandShuffleCancel(int handle) {
+    auto& jobs = SlicedShuffleJobs();
+    auto it = std::find(jobs.begin(), jobs.end(), handle);
+    if (it == jobs.end()) return false;
+    jobs.erase(it);
+    return SlicedShufflePool().Remove(handle);
+}
+
+// Called once per server tick
+inline void ProcessSlicedShuffles() {
+    auto& jobs = SlicedShuffleJobs();
+    for (size_t i = 0; i < jobs.size();) {
+        SlicedShuffle* job = SlicedShufflePool().Get(jobs[i]);
+        if (job != nullptr && !job->Step()) {
+            i++;
+            continue;
+        }
+        if (job != nullptr) {
+            // Freed only after the callback, so a RandShuffleBegin earlier in
+            // the same tick cannot be handed this handle
+            int handle = jobs[i];
+            PendingCallbacks().Push({job->Owner(), "OnRandShuffleDone", {handle}, [handle] {
+                SlicedShufflePool().Remove(handle);
+            }});
+        }
+        jobs.erase(jobs.begin() + i);
+    }
+}
+
+// Also frees finished jobs whose OnRandShuffleDone is still queued
+inline void ReleaseSlicedShuffles(void* owner) {
+    for (int handle = 1; handle <= SlicedShufflePool().Capacity(); handle++) {
+        SlicedShuffle* job = SlicedShufflePool().Get(handle);
+        if (job != nullptr && job->Owner() == owner) SlicedShufflePool().Remove(handle);
+    }
+    auto& jobs = SlicedShuffleJobs();
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(),
+        [](int handle) { return SlicedShufflePool().Get(handle) == nullptr; }), jobs.end());
+}
+
+// RandLoot - hierarchical loot tables loaded from INI files under scriptfiles/.
+//
+//   [chest]
+//   rolls  = 1-3           ; weighted picks per roll (default 1)
+//   entry  = 70, 1001, 1-3 ; weight, item id, quantity range
+//   entry  = 25, @gems     ; nested table, rolled recursively
+//   entry  = 5, none       ; explicit "nothing" outcome
+//   always = 500, 1        ; guaranteed drop (item or @table)
+//
+// Every table compiles to an alias table. Loading a file again swaps in the
+// new tables only if the whole file parses, so a bad edit never leaves a
+// half-loaded file. Table handles are bound to names and survive reloads.
+
+struct LootEntry {
+    int32_t item = 0;
+    int32_t qtyMin = 1, qtyMax = 1;
+    int32_t table = -1;     // Nested table index in the same file
+    bool nothing = false;
+};
+
+struct LootTable {
+    int32_t rollsMin = 1, rollsMax = 1;
+    std::vector<LootEntry> entries;
+    std::vector<LootEntry> always;
+    AliasTable alias;
+};
+
+struct LootFile {
+    std::vector<LootTable> tables;
+    std::unordered_map<std::string, int32_t> index;
+};
+
+class LootRegistry {
+private:
+    std::map<std::string, std::shared_ptr<const LootFile>> files_;
+    std::vector<std::string> names_;                    // Handle - 1 -> table name
+    std::unordered_map<std::string, int> handles_;
+    
+    static std::string Trim(const std::string& str) {
+        size_t a = str.find_first_not_of(" \t\r\n");
+        if (a == std::string::npos) return "";
+        size_t b = str.find_last_not_of(" \t\r\n");
+        return str.substr(a, b - a + 1);
+    }
+    
+    static bool ParseRange(const std::string& text, int32_t& lo, int32_t& hi) {
+        std::string t = Trim(text);
+        if (t.empty()) return false;
+        char* end;
+        long long a = std::strtoll(t.c_str(), &end, 10);
+        long long b = a;
+        if (*end == '-') {
+            const char* rest = end + 1;
+            b = std::strtoll(rest, &end, 10);
+            if (end == rest) return false;
+        }
+        if (*end != '\0' || a < 0 || b < a || b > 0x7FFFFFFF) return false;
+        lo = static_cast<int32_t>(a);
+        hi = static_cast<int32_t>(b);
+        return true;
+    }
+    
+    static std::vector<std::string> Split(const std::string& value) {
+        std::vector<std::string> parts;
+        size_t start = 0;
+        for (;;) {
+            size_t comma = value.find(',', start);
+            parts.push_back(Trim(value.substr(start, comma - start)));
+            if (comma == std::string::npos) break;
+            start = comma + 1;
+        }
+        return parts;
+    }
+    
+    // "item[, qty]" or "@table" or "none"; table references are resolved later
+    static bool ParseOutcome(const std::vector<std::string>& parts, size_t first, LootEntry& entry, std::string& ref) {
+        if (first >= parts.size()) return false;
+        const std::string& what = parts[first];
+        if (what == "none") {
+            entry.nothing = true;
+            return parts.size() == first + 1;
+        }
+        if (!what.empty() && what[0] == '@') {
+            ref = what.substr(1);
+            return !ref.empty() && parts.size() == first + 1;
+        }
+        char* end;
+        long long item = std::strtoll(what.c_str(), &end, 10);
+        if (what.empty() || *end != '\0' || item < INT32_MIN || item > INT32_MAX) return false;
+        entry.item = static_cast<int32_t>(item);
+        if (parts.size() > first + 1 && !ParseRange(parts[first + 1], entry.qtyMin, entry.qtyMax)) return false;
+        return parts.size() <= first + 2;
+    }
+    
+    static std::shared_ptr<LootFile> Parse(FILE* f) {
+        auto file = std::make_shared<LootFile>();
+        std::vector<std::vector<std::string>> entryRefs, alwaysRefs;
+        std::vector<std::vector<double>> weights;
+        int32_t current = -1;
+        char line[512];
+        
+        while (std::fgets(line, sizeof(line), f)) {
+            std::string text(line);
+            size_t comment = text.find_first_of(";#");
+            if (comment != std::string::npos) text.resize(comment);
+            text = Trim(text);
+            if (text.empty()) continue;
+            
+            if (text[0] == '[') {
+                if (text.back() != ']') return nullptr;
+                std::string name = Trim(text.substr(1, text.size() - 2));
+                if (name.empty() || file->index.count(name)) return nullptr;
+                current = static_cast<int32_t>(file->tables.size());
+                file->index[name] = current;
+                file->tables.emplace_back();
+                entryRefs.emplace_back();
+                alwaysRefs.emplace_back();
+                weights.emplace_back();
+                continue;
+            }
+            
+            size_t eq = text.find('=');
+            if (eq == std::string::npos || current < 0) return nullptr;
+            std::string key = Trim(text.substr(0, eq));
+            std::vector<std::string> parts = Split(text.substr(eq + 1));
+            LootTable& table = file->tables[current];
+            
+            if (key == "rolls") {
+                if (parts.size() != 1 || !ParseRange(parts[0], table.rollsMin, table.rollsMax)) return nullptr;
+                if (table.rollsMax > 64) return nullptr;
+            } else if (key == "entry") {
+                char* end;
+                double weight = std::strtod(parts[0].c_str(), &end);
+                if (parts[0].empty() || *end != '\0' || !(weight > 0.0) || !std::isfinite(weight)) return nullptr;
+                LootEntry entry;
+                std::string ref;
+                if (!ParseOutcome(parts, 1, entry, ref)) return nullptr;
+                table.entries.push_back(entry);
+                entryRefs[current].push_back(ref);
+                weights[current].push_back(weight);
+            } else if (key == "always") {
+                LootEntry entry;
+                std::string ref;
+                if (!ParseOutcome(parts, 0, entry, ref) || entry.nothing) return nullptr;
+                table.always.push_back(entry);
+                alwaysRefs[current].push_back(ref);
+            } else {
+                return nullptr;
+            }
+        }
+        
+        // Resolve @references and compile alias tables
+        for (size_t t = 0; t < file->tables.size(); t++) {
+            LootTable& table = file->tables[t];
+            auto resolve = [&](std::vector<LootEntry>& list, const std::vector<std::string>& refs) {
+                for (size_t i = 0; i < list.size(); i++) {
+                    if (refs[i].empty()) continue;
+                    auto it = file->index.find(refs[i]);
+                    if (it == file->index.end()) return false;
+                    list[i].table = it->second;
+                }
+                return true;
+            };
+            if (!resolve(table.entries, entryRefs[t]) || !resolve(table.always, alwaysRefs[t])) return nullptr;
+            // Finite weights can still sum to infinity, which turns every
+            // scaled weight into NaN
+            if (!table.entries.empty() && !table.alias.Build(weights[t])) return nullptr;
+        }
+        if (file->tables.empty() || !CheckNesting(*file)) return nullptr;
+        return file;
+    }
+    
+    // Worst-case outcomes a single roll of a table can expand into
+    static constexpr double MAX_EXPANSION = 1000000.0;
+    
+    // Rejects reference cycles and nesting that could expand past
+    // MAX_EXPANSION outcomes, so a roll is always bounded work. Iterative DFS
+    // with post-order cost: always entries add up, weighted picks take the
+    // costliest entry rollsMax times.
+    static bool CheckNesting(const LootFile& file) {
+        size_t n = file.tables.size();
+        std::vector<uint8_t> state(n, 0);       // 0 = new, 1 = on stack, 2 = done
+        std::vector<double> cost(n, 0.0);
+        
+        for (size_t root = 0; root < n; root++) {
+            if (state[root] != 0) continue;
+            std::vector<std::pair<size_t, size_t>> stack = { { root, 0 } };
+            state[root] = 1;
+            while (!stack.empty()) {
+                size_t t = stack.back().first;
+                const LootTable& table = file.tables[t];
+                size_t next = stack.back().second++;
+                size_t refs = table.always.size() + table.entries.size();
+                if (next < refs) {
+                    const LootEntry& e = next < table.always.size() ? table.always[next]
+                                                                    : table.entries[next - table.always.size()];
+                    if (e.table < 0) continue;
+                    if (state[e.table] == 1) return false;      // Cycle
+                    if (state[e.table] == 0) {
+                        state[e.table] = 1;
+                        stack.push_back({ static_cast<size_t>(e.table), 0 });
+                    }
+                    continue;
+                }
+                
+                auto outcome = [&](const LootEntry& e) { return e.table >= 0 ? cost[e.table] : 1.0; };
+                double total = 0.0, worst = 0.0;
+                for (const LootEntry& e : table.always) total += outcome(e);
+                for (const LootEntry& e : table.entries) worst = std::max(worst, outcome(e));
+                total += worst * table.rollsMax;
+                if (total > MAX_EXPANSION) return false;
+                cost[t] = total;
+                state[t] = 2;
+                stack.pop_back();
+            }
+        }
+        return true;
+    }
+    
+    struct Drops {
+        int32_t* dest;
+        int capacity;
+        int count;
+    };
+    
+    // Caller must hold rng_mutex
+    static void Emit(const LootFile& file, const LootEntry& entry, ChaChaRNG& rng, Drops& out) {
+        if (entry.nothing || out.count >= out.capacity) return;
+        if (entry.table >= 0) {
+            RollTable(file, entry.table, rng, out);
+            return;
+        }
+        uint32_t span = static_cast<uint32_t>(entry.qtyMax - entry.qtyMin) + 1;
+        out.dest[out.count * 2] = entry.item;
+        out.dest[out.count * 2 + 1] = entry.qtyMin + static_cast<int32_t>(rng.next_bounded(span));
+        out.count++;
+    }
+    
+    // Files are acyclic and expansion-bounded (CheckNesting), so this terminates
+    static void RollTable(const LootFile& file, int32_t index, ChaChaRNG& rng, Drops& out) {
+        const LootTable& table = file.tables[index];
+        
+        for (const LootEntry& entry : table.always) {
+            Emit(file, entry, rng, out);
+        }
+        if (table.entries.empty()) return;
+        
+        uint32_t span = static_cast<uint32_t>(table.rollsMax - table.rollsMin) + 1;
+        int rolls = table.rollsMin + static_cast<int>(rng.next_bounded(span));
+        for (int r = 0; r < rolls && out.count < out.capacity; r++) {
+            Emit(file, table.entries[table.alias.Sample(rng)], rng, out);
+        }
+    }
+    
+public:
+    // Returns the number of tables in the file, 0 if it is missing or invalid
+    int Load(const char* filename) {
+        std::string path;
+        if (!ScriptFilePath(filename, path)) return 0;
+        
+        FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return 0;
+        std::shared_ptr<LootFile> file = Parse(f);
+        std::fclose(f);
+        if (!file) return 0;
+        
+        files_[path] = file;
+        return static_cast<int>(file->tables.size());
+    }
+    
+    int Handle(const char* name) {
+        auto it = handles_.find(name);
+        if (it != handles_.end()) return it->second;
+        if (names_.size() >= 65536) return 0;
+        names_.emplace_back(name);
+        int handle = static_cast<int>(names_.size());
+        handles_[name] = handle;
+        return handle;
+    }
+    
+    // Returns drops written (item, quantity pairs), -1 if the table is unknown
+    int Roll(int handle, int32_t* dest, int capacity) {
+        if (handle <= 0 || handle > static_cast<int>(names_.size())) return -1;
+        const std::string& name = names_[handle - 1];
+        
+        // If several files define the name, the first by path wins
+        for (const auto& entry : files_) {
+            auto it = entry.second->index.find(name);
+            if (it == entry.second->index.end()) continue;
+            
+            std::shared_ptr<const LootFile> file = entry.second;
+            Drops out{dest, capacity, 0};
+            std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+            RollTable(*file, it->second, Randomix::GetRNG(), out);
+            return out.count;
+        }
+        return -1;
+    }
+};
+
+inline LootRegistry& Loot() {
+    static LootRegistry registry;
+    return registry;
+}
+
+inline int ImplRandLootLoad(const char* filename) {
+    return Loot().Load(filename);
+}
+
+inline int ImplRandLootTable(const char* name) {
+    if (name == nullptr || name[0] == '\0') return 0;
+    return Loot().Handle(name);
+}
+
+inline int ImplRandLootRoll(int table, int32_t* dest, int maxCells) {
+    if (dest == nullptr || maxCells < 2) return -1;
+    return Loot().Roll(table, dest, maxCells / 2);
+}
+
+// RandSelector - weighted picks biased towards least-recently-used items.
+// Item i weighs base_i * decay^last_i, where last_i is the pick counter at
+// its last use: an item picked k picks more recently than another weighs
+// decay^k times as much, and that ratio never changes afterwards, so only the
+// used item's leaf is updated. Leaves live in a segment tree (sums recomputed
+// from children, so no floating-point drift) for O(log n) pick and update.
+// Picked items can also sit out a hard cooldown in milliseconds.
+
+class Selector {
+private:
+    size_t count_;
+    size_t leaves_;                 // Power of two >= count
+    std::vector<double> tree_;      // tree_[1] is the total; leaves at [leaves_, 2 * leaves_)
+    std::vector<double> base_;
+    std::vector<int64_t> last_;     // Pick counter at last use
+    std::vector<int64_t> coolUntil_;
+    std::deque<std::pair<int64_t, uint32_t>> cooling_;  // (release ms, index), release order
+    double decay_;
+    int64_t horizon_;               // Picks after which decay^picks underflows the useful range
+    int64_t cooldownMs_;
+    int64_t tick_ = 0;
+    int64_t epoch_ = 0;
+    
+    static int64_t NowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+    double LeafWeight(size_t i) const {
+        if (coolUntil_[i] != 0) return 0.0;
+        return base_[i] * std::pow(decay_, static_cast<double>(last_[i] - epoch_));
+    }
+    
+    void SetLeaf(size_t i) {
+        size_t node = leaves_ + i;
+        tree_[node] = LeafWeight(i);
+        for (node >>= 1; node >= 1; node >>= 1) {
+            tree_[node] = tree_[2 * node] + tree_[2 * node + 1];
+        }
+    }
+    
+    void Rebuild() {
+        for (size_t i = 0; i < count_; i++) tree_[leaves_ + i] = LeafWeight(i);
+        for (size_t node = leaves_ - 1; node >= 1; node--) {
+            tree_[node] = tree_[2 * node] + tree_[2 * node + 1];
+        }
+    }
+    
+    // Keeps weights within about e^+-300: re-centre on the current pick and
+    // treat anything older than the horizon as exactly horizon picks old
+    void Renormalize() {
+        epoch_ = tick_;
+        for (size_t i = 0; i < count_; i++) {
+            last_[i] = std::max(last_[i], epoch_ - horizon_);
+        }
+        Rebuild();
+    }
+    
+    void ReleaseCooldowns() {
+        if (cooling_.empty()) return;
+        int64_t now = NowMs();
+        while (!cooling_.empty() && cooling_.front().first <= now) {
+            uint32_t i = cooling_.front().second;
+            // Stale if the item was used again after this entry was queued
+            if (coolUntil_[i] == cooling_.front().first) {
+                coolUntil_[i] = 0;
+                SetLeaf(i);
+            }
+            cooling_.pop_front();
+        }
+    }
+    
+public:
+    Selector(size_t count, double decay, int64_t cooldownMs)
+        : count_(count), leaves_(1), base_(count, 1.0), last_(count, 0), coolUntil_(count, 0),
+          decay_(decay), cooldownMs_(cooldownMs) {
+        while (leaves_ < count_) leaves_ <<= 1;
+        tree_.assign(2 * leaves_, 0.0);
+        horizon_ = decay_ < 1.0 ? std::max<int64_t>(1, static_cast<int64_t>(300.0 / -std::log(decay_))) : INT64_MAX;
+        Rebuild();
+    }
+    
+    // Marks an item as used now: it drops to the back of the recency order
+    // and starts its cooldown
+    void Touch(uint32_t i) {
+        tick_++;
+        if (tick_ - epoch_ >= horizon_) Renormalize();
+        last_[i] = tick_;
+        if (cooldownMs_ > 0) {
+            coolUntil_[i] = NowMs() + cooldownMs_;
+            cooling_.emplace_back(coolUntil_[i], i);
+        }
+        SetLeaf(i);
+    }
+    
+    // Returns the picked index, -1 if every item has zero weight or is cooling down
+    int Pick() {
+        ReleaseCooldowns();
+        if (!(tree_[1] > 0.0)) return -1;
+        
+        double r;
+        {
+            std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+            r = NextUnitDouble(Randomix::GetRNG()) * tree_[1];
+        }
+        
+        size_t node = 1;
+        while (node < leaves_) {
+            double left = tree_[2 * node];
+            // Rounding can leave r at the edge; never step into an empty subtree
+            if ((r < left && left > 0.0) || tree_[2 * node + 1] <= 0.0) {
+                node = 2 * node;
+            } else {
+                r -= left;
+                node = 2 * node + 1;
+            }
+        }
+        
+        uint32_t index = static_cast<uint32_t>(node - leaves_);
+        Touch(index);
+        return static_cast<int>(index);
+    }
+    
+    void SetWeight(uint32_t i, double weight) {
+        base_[i] = weight;
+        SetLeaf(i);
+    }
+    
+    // Forget recency and cooldowns; base weights are kept
+    void Reset() {
+        std::fill(last_.begin(), last_.end(), 0);
+        std::fill(coolUntil_.begin(), coolUntil_.end(), 0);
+        cooling_.clear();
+        tick_ = epoch_ = 0;
+        Rebuild();
+    }
+    
+    size_t Count() const { return count_; }
+};
+
+inline HandlePool<Selector>& SelectorPool() {
+    static HandlePool<Selector> pool;
+    return pool;
+}
+
+inline int ImplRandSelectorCreate(int count, float decay, int cooldownMs) {
+    if (count <= 0 || count > 10000000) return 0;
+    if (!(decay > 0.0f && decay <= 1.0f) || cooldownMs < 0) return 0;
+    return SelectorPool().Add(std::make_unique<Selector>(static_cast<size_t>(count), decay, cooldownMs));
+}
+
+inline int ImplRandSelectorPick(int handle) {
+    Selector* selector = SelectorPool().Get(handle);
+    return selector ? selector->Pick() : -1;
+}
+
+inline bool ImplRandSelectorTouch(int handle, int index) {
+    Selector* selector = SelectorPool().Get(handle);
+    if (selector == nullptr || index < 0 || static_cast<size_t>(index) >= selector->Count()) return false;
+    selector->Touch(static_cast<uint32_t>(index));
+    return true;
+}
+
+inline bool ImplRandSelectorSetWeight(int handle, int index, float weight) {
+    Selector* selector = SelectorPool().Get(handle);
+    if (selector == nullptr || index < 0 || static_cast<size_t>(index) >= selector->Count()) return false;
+    if (!(weight >= 0.0f) || std::isinf(weight)) return false;
+    selector->SetWeight(static_cast<uint32_t>(index), weight);
+    return true;
+}
+
+inline bool ImplRandSelectorReset(int handle) {
+    Selector* selector = SelectorPool().Get(handle);
+    if (selector == nullptr) return false;
+    selector->Reset();
+    return true;
+}
+
+inline bool ImplRandSelectorDestroy(int handle) {
+    return SelectorPool().Remove(handle);
+}
+
+// Reservoir sampling (Algorithm R): up to k distinct uniform picks from a
+// stream of unknown length in one pass, e.g. a server entity pool scanned
+// through a filter. Finish() shuffles the kept ids so their order is random
+// too. Caller must hold rng_mutex for the whole scan.
+
+class Reservoir {
+private:
+    int32_t* out_;
+    uint32_t k_;
+    uint32_t seen_ = 0;
+    ChaChaRNG& rng_;
+    
+public:
+    Reservoir(ChaChaRNG& rng, int32_t* out, int k)
+        : out_(out), k_(k > 0 ? static_cast<uint32_t>(k) : 0), rng_(rng) {}
+    
+    void Offer(int32_t id) {
+        if (seen_ < k_) {
+            out_[seen_] = id;
+        } else {
+            uint32_t j = rng_.next_bounded(seen_ + 1);
+            if (j < k_) out_[j] = id;
+        }
+        seen_++;
+    }
+    
+    // Returns the number of ids kept
+    int Finish() {
+        uint32_t kept = std::min(seen_, k_);
+        for (uint32_t i = kept; i > 1; i--) {
+            std::swap(out_[i - 1], out_[rng_.next_bounded(i)]);
+        }
+        return static_cast<int>(kept);
+    }
+};
+
+// Uniform-grid spatial index over entity positions, bucketed on x/y (z is
+// checked exactly). Rebuilt wholesale from a position snapshot; a sphere
+// query only visits the cells its bounding square touches, so its cost
+// follows the local density rather than the entity count.
+
+struct GridEntity {
+    int32_t id;
+    int32_t world;
+    uint32_t flags;
+    float x, y, z;
+};
+
+class SpatialGrid {
+private:
+    static constexpr float CELL_SIZE = 50.0f;
+    
+    std::vector<GridEntity> entities_;      // Sorted by cell after Build()
+    std::vector<uint64_t> keys_;
+    std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> cells_;   // Cell -> [begin, end)
+    
+    // Clamped so far-off positions cannot overflow the cast; queries only
+    // use cells well inside the clamp, so clamped entities are never missed
+    static int32_t CellOf(float v) {
+        float cell = std::floor(v / CELL_SIZE);
+        return static_cast<int32_t>(std::max(-1.0e9f, std::min(cell, 1.0e9f)));
+    }
+    
+    static uint64_t Key(int32_t cx, int32_t cy) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+    }
+    
+public:
+    void Clear() {
+        entities_.clear();
+        cells_.clear();
+    }
+    
+    // Entities at non-finite positions can never be inside a query sphere
+    void Add(const GridEntity& entity) {
+        if (!std::isfinite(entity.x) || !std::isfinite(entity.y) || !std::isfinite(entity.z)) return;
+        entities_.push_back(entity);
+    }
+    
+    void Build() {
+        keys_.resize(entities_.size());
+        std::vector<uint32_t> order(entities_.size());
+        for (size_t i = 0; i < entities_.size(); i++) {
+            keys_[i] = Key(CellOf(entities_[i].x), CellOf(entities_[i].y));
+            order[i] = static_cast<uint32_t>(i);
+        }
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys_[a] < keys_[b]; });
+        
+        std::vector<GridEntity> sorted(entities_.size());
+        std::vector<uint64_t> sortedKeys(entities_.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            sorted[i] = entities_[order[i]];
+            sortedKeys[i] = keys_[order[i]];
+        }
+        entities_.swap(sorted);
+        keys_.swap(sortedKeys);
+        
+        cells_.clear();
+        for (uint32_t i = 0; i < keys_.size(); ) {
+            uint32_t j = i;
+            while (j < keys_.size() && keys_[j] == keys_[i]) j++;
+            cells_[keys_[i]] = {i, j};
+            i = j;
+        }
+    }
+    
+    // Calls visit(entity) for every entity inside the sphere
+    template<typename Visit>
+    void Query(float x, float y, float z, float radius, Visit&& visit) const {
+        Search(x, y, z, radius, [&](const GridEntity& e) {
+            visit(e);
+            return true;
+        });
+    }
+    
+    // True if any entity inside the sphere satisfies pred; stops at the first
+    template<typename Pred>
+    bool Any(float x, float y, float z, float radius, Pred&& pred) const {
+        return !Search(x, y, z, radius, [&](const GridEntity& e) { return !pred(e); });
+    }
+    
+private:
+    // Feeds entities inside the sphere to visit until it returns false;
+    // returns false if the search was cut short
+    template<typename Visit>
+    bool Search(float x, float y, float z, float radius, Visit&& visit) const {
+        float r2 = radius * radius;
+        auto inside = [&](const GridEntity& e) {
+            float dx = e.x - x, dy = e.y - y, dz = e.z - z;
+            return dx * dx + dy * dy + dz * dz <= r2;
+        };
+        
+        // A huge radius touches more cells than there are entities: scan instead
+        bool scan = !(std::fabs(x) + radius < 1.0e8f && std::fabs(y) + radius < 1.0e8f);
+        int64_t x0 = 0, x1 = 0, y0 = 0, y1 = 0;
+        if (!scan) {
+            x0 = CellOf(x - radius); x1 = CellOf(x + radius);
+            y0 = CellOf(y - radius); y1 = CellOf(y + radius);
+            scan = (x1 - x0 + 1) * (y1 - y0 + 1) > static_cast<int64_t>(cells_.size());
+        }
+        if (scan) {
+            for (const GridEntity& e : entities_) {
+                if (inside(e) && !visit(e)) return false;
+            }
+            return true;
+        }
+        
+        for (int64_t cx = x0; cx <= x1; cx++) {
+            for (int64_t cy = y0; cy <= y1; cy++) {
+                auto it = cells_.find(Key(static_cast<int32_t>(cx), static_cast<int32_t>(cy)));
+                if (it == cells_.end()) continue;
+                for (uint32_t i = it->second.first; i < it->second.second; i++) {
+                    if (inside(entities_[i]) && !visit(entities_[i])) return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+// RandTeams - balanced random partition. Team sizes differ by at most one.
+// Players are shuffled, then stably sorted by score (so equal scores land in
+// random order) and dealt greedily to the open team with the lowest total;
+// pairwise swaps then shrink the spread of team totals. Team labels are
+// permuted so team 0 is not always the first to fill. Randomness is drawn
+// up front; the balancing itself runs without holding rng_mutex.
+
+constexpr int RANDIX_TEAMS_MAX_PLAYERS = 1000;
+
+inline bool ImplRandTeams(const int32_t* scores, int count, int teams, int32_t* outTeam) {
+    if (scores == nullptr || outTeam == nullptr || count <= 0 || count > RANDIX_TEAMS_MAX_PLAYERS) return false;
+    if (teams <= 0 || teams > count) return false;
+    
+    std::vector<uint32_t> order(static_cast<size_t>(count));
+    std::vector<int32_t> labels(static_cast<size_t>(teams));
+    for (int i = 0; i < count; i++) order[i] = static_cast<uint32_t>(i);
+    for (int t = 0; t < teams; t++) labels[t] = t;
+    
+    {
+        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+        ChaChaRNG& rng = Randomix::GetRNG();
+        for (uint32_t i = static_cast<uint32_t>(count); i > 1; i--) {
+            std::swap(order[i - 1], order[rng.next_bounded(i)]);
+        }
+        for (uint32_t i = static_cast<uint32_t>(teams); i > 1; i--) {
+            std::swap(labels[i - 1], labels[rng.next_bounded(i)]);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return scores[a] > scores[b]; });
+    
+    // Greedy: highest scores first, each to the open team with the lowest total
+    int bigTeams = count % teams;
+    int small = count / teams;
+    std::vector<int64_t> sums(static_cast<size_t>(teams), 0);
+    std::vector<std::vector<uint32_t>> members(static_cast<size_t>(teams));
+    for (uint32_t p : order) {
+        int best = -1;
+        for (int t = 0; t < teams; t++) {
+            int size = static_cast<int>(members[t].size());
+            // Only `bigTeams` teams may take the extra player
+            if (size > small || (size == small && bigTeams == 0)) continue;
+            if (best < 0 || sums[t] < sums[best]) best = t;
+        }
+        if (members[best].size() == static_cast<size_t>(small)) bigTeams--;
+        members[best].push_back(p);
+        sums[best] += scores[p];
+    }
+    
+    // Local search: swap the pair that moves two teams' totals closest together
+    // (minimises the sum of squared totals); stop when no swap helps.
+    // Swapping x (in a) and y (in b) changes the gap by 2 * (y - x), so with
+    // both teams sorted by score a two-pointer pass finds the best pair.
+    auto byScore = [&](uint32_t p, uint32_t q) { return scores[p] < scores[q]; };
+    for (int round = 0; round < 64; round++) {
+        bool improved = false;
+        for (int a = 0; a < teams; a++) {
+            for (int b = a + 1; b < teams; b++) {
+                int64_t gap = sums[a] - sums[b];
+                if (gap == 0) continue;
+                
+                std::vector<uint32_t>& ma = members[a];
+                std::vector<uint32_t>& mb = members[b];
+                std::sort(ma.begin(), ma.end(), byScore);
+                std::sort(mb.begin(), mb.end(), byScore);
+                
+                int64_t bestGap = gap < 0 ? -gap : gap;
+                size_t bestX = 0, bestY = 0;
+                bool found = false;
+                for (size_t x = 0, y = 0; x < ma.size() && y < mb.size();) {
+                    int64_t newGap = gap + 2 * (static_cast<int64_t>(scores[mb[y]]) - scores[ma[x]]);
+                    int64_t absGap = newGap < 0 ? -newGap : newGap;
+                    if (absGap < bestGap) {
+                        bestGap = absGap;
+                        bestX = x;
+                        bestY = y;
+                        found = true;
+                    }
+                    if (newGap < 0) y++;        // Need a larger y - x
+                    else if (newGap > 0) x++;   // Need a smaller y - x
+                    else break;
+                }
+                if (!found) continue;
+                
+                int64_t delta = static_cast<int64_t>(scores[mb[bestY]]) - scores[ma[bestX]];
+                std::swap(ma[bestX], mb[bestY]);
+                sums[a] += delta;
+                sums[b] -= delta;
+                improved = true;
+            }
+        }
+        if (!improved) break;
+    }
+    
+    for (int t = 0; t < teams; t++) {
+        for (uint32_t p : members[t]) outTeam[p] = labels[t];
+    }
+    return true;
+}
+
+// RandSpawn - spawn point sets with team tags (-1 = any team). Pick() draws
+// uniformly among the points the caller's predicate does not block, in one
+// reservoir pass; the server side supplies "is an enemy too close".
+
+struct SpawnPoint {
+    float x, y, z, angle;
+    int32_t team;
+};
+
+class SpawnSet {
+private:
+    std::vector<SpawnPoint> points_;
+    
+public:
+    int Add(const SpawnPoint& point) {
+        if (points_.size() >= 100000) return -1;
+        points_.push_back(point);
+        return static_cast<int>(points_.size()) - 1;
+    }
+    
+    const SpawnPoint* Get(int index) const {
+        if (index < 0 || static_cast<size_t>(index) >= points_.size()) return nullptr;
+        return &points_[index];
+    }
+    
+    int Count() const { return static_cast<int>(points_.size()); }
+    
+    // Returns a point index, -1 if every point is blocked or tagged for another team
+    template<typename Blocked>
+    int Pick(int32_t team, Blocked&& blocked) const {
+        int32_t index;
+        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+        Reservoir reservoir(Randomix::GetRNG(), &index, 1);
+        for (size_t i = 0; i < points_.size(); i++) {
+            const SpawnPoint& point = points_[i];
+            if (point.team != -1 && point.team != team) continue;
+            if (blocked(point)) continue;
+            reservoir.Offer(static_cast<int32_t>(i));
+        }
+        return reservoir.Finish() ? index : -1;
+    }
+};
+
+inline HandlePool<SpawnSet>& SpawnSetPool() {
+    static HandlePool<SpawnSet> pool;
+    return pool;
+}
+
+inline int ImplRandSpawnCreate() {
+    return SpawnSetPool().Add(std::make_unique<SpawnSet>());
+}
+
+inline int ImplRandSpawnAdd(int handle, float x, float y, float z, float angle, int team) {
+    SpawnSet* set = SpawnSetPool().Get(handle);
+    if (set == nullptr) return -1;
+    if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z) || !std::isfinite(angle)) return -1;
+    return set->Add({x, y, z, angle, team});
+}
+
+inline bool ImplRandSpawnGet(int handle, int index, float& x, float& y, float& z, float& angle) {
+    SpawnSet* set = SpawnSetPool().Get(handle);
+    const SpawnPoint* point = set ? set->Get(index) : nullptr;
+    if (point == nullptr) return false;
+    x = point->x;
+    y = point->y;
+    z = point->z;
+    angle = point->angle;
+    return true;
+}
+
+inline int ImplRandSpawnCount(int handle) {
+    SpawnSet* set = SpawnSetPool().Get(handle);
+    return set ? set->Count() : 0;
+}
+
+inline bool ImplRandSpawnDestroy(int handle) {
+    return SpawnSetPool().Remove(handle);
+}
+
+// Keyed permutations
+
+// Derive a 256-bit key: random when seed is 0, otherwise a fixed function of
+// (seed, domain) so handles recreated with the same seed map identically.
+inline void DeriveKey(uint32_t seed, uint32_t domain, uint32_t* key) {
+    if (seed == 0) {
+        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+        for (int i = 0; i < 8; i++) {
+            key[i] = Randomix::GetRNG().next_uint32();
+        }
+        return;
+    }
+    
+    uint32_t base[8] = { seed, ~seed, domain, 0x52616E64, 0x6F6D6978, 0, 0, 0 };
+    uint32_t block[16];
+    ChaChaRNG::keyed_block(base, 0, domain, block);
+    std::copy(block, block + 8, key);
+    std::fill(block, block + 16, 0);
+}
+
+// Key from a secret string: each 32-byte chunk is XORed into the chaining
+// key and compressed by a ChaCha block; a final block binds the length.
+// Unlike a 32-bit seed, a long random secret cannot be searched offline.
+inline void DeriveKeyFromSecret(const char* secret, size_t len, uint32_t domain, uint32_t* key) {
+    uint32_t state[8] = { domain, ~domain, 0x52616E64, 0x6F6D6978, 0, 0, 0, 0 };
+    uint32_t block[16];
+    uint64_t chunks = (len + 31) / 32;
+    
+    for (uint64_t c = 0; c < chunks; c++) {
+        for (size_t i = 0; i < 32 && c * 32 + i < len; i++) {
+            state[i / 4] ^= static_cast<uint32_t>(static_cast<uint8_t>(secret[c * 32 + i])) << (8 * (i % 4));
+        }
+        ChaChaRNG::keyed_block(state, c, domain, block);
+        std::copy(block, block + 8, state);
+    }
+    ChaChaRNG::keyed_block(state, ~static_cast<uint64_t>(len), domain, block);
+    std::copy(block, block + 8, key);
+    std::fill(block, block + 16, 0);
+    std::fill(state, state + 8, 0);
+}
+
+// Bijection on [0, domain) for any domain < 2^62: a balanced 10-round
+// Feistel network over the smallest even bit width covering the domain,
+// ChaCha8 as round function, cycle-walked back into range (< 4 steps on average).
+class FeistelPermutation {
+private:
+    static constexpr int ROUNDS = 10;
+    static constexpr int PRF_ROUNDS = 8;
+    uint64_t domain_;
+    int halfBits_;
+    uint32_t halfMask_;
+    uint32_t key_[8];
+    
+    uint32_t Round(int round, uint32_t half) const {
+        uint32_t block[16];
+        ChaChaRNG::keyed_block(key_, half, static_cast<uint64_t>(round), block, PRF_ROUNDS);
+        return block[0] & halfMask_;
+    }
+    
+    uint64_t Encrypt(uint64_t x) const {
+        uint32_t left = static_cast<uint32_t>(x >> halfBits_);
+        uint32_t right = static_cast<uint32_t>(x) & halfMask_;
+        for (int r = 0; r < ROUNDS; r++) {
+            uint32_t next = left ^ Round(r, right);
+            left = right;
+            right = next;
+        }
+        return (static_cast<uint64_t>(left) << halfBits_) | right;
+    }
+    
+    uint64_t Decrypt(uint64_t y) const {
+        uint32_t left = static_cast<uint32_t>(y >> halfBits_);
+        uint32_t right = static_cast<uint32_t>(y) & halfMask_;
+        for (int r = ROUNDS - 1; r >= 0; r--) {
+            uint32_t prev = right ^ Round(r, left);
+            right = left;
+            left = prev;
+        }
+        return (static_cast<uint64_t>(left) << halfBits_) | right;
+    }
+    
+public:
+    FeistelPermutation(uint64_t domain, const uint32_t* key) : domain_(domain) {
+        int bits = 2;
+        while (bits < 62 && (1ULL << bits) < domain) bits += 2;
+        halfBits_ = bits / 2;
+        halfMask_ = (1u << halfBits_) - 1;
+        std::copy(key, key + 8, key_);
+    }
+    
+    ~FeistelPermutation() {
+        std::fill(key_, key_ + 8, 0);
+    }
+    
+    uint64_t Domain() const { return domain_; }
+    
+    uint64_t Permute(uint64_t x) const {
+        uint64_t y = Encrypt(x);
+        while (y >= domain_) y = Encrypt(y);
+        return y;
+    }
+    
+    uint64_t Invert(uint64_t y) const {
+        uint64_t x = Decrypt(y);
+        while (x >= domain_) x = Decrypt(x);
+        return x;
+    }
+};
+
+// RandPerm - random-access permutation of [0, n) without storing it
+
+inline HandlePool<FeistelPermutation>& PermutationPool() {
+    static HandlePool<FeistelPermutation> pool;
+    return pool;
+}
+
+inline int ImplRandPermCreate(int n, uint32_t seed) {
+    if (n <= 0) return 0;
+    
+    uint32_t key[8];
+    DeriveKey(seed, 0x5045524D, key);
+    int handle = PermutationPool().Add(std::make_unique<FeistelPermutation>(static_cast<uint64_t>(n), key));
+    std::fill(key, key + 8, 0);
+    return handle;
+}
+
+// Returns -1 on invalid handle or index
+inline int ImplRandPermAt(int handle, int index) {
+    FeistelPermutation* perm = PermutationPool().Get(handle);
+    if (perm == nullptr) return -1;
+    if (index < 0 || static_cast<uint64_t>(index) >= perm->Domain()) return -1;
+    return static_cast<int>(perm->Permute(static_cast<uint64_t>(index)));
+}
+
+// Inverse lookup: position of `value` in the permuted order, -1 on invalid input
+inline int ImplRandPermIndexOf(int handle, int value) {
+    FeistelPermutation* perm = PermutationPool().Get(handle);
+    if (perm == nullptr) return -1;
+    if (value < 0 || static_cast<uint64_t>(value) >= perm->Domain()) return -1;
+    return static_cast<int>(perm->Invert(static_cast<uint64_t>(value)));
+}
+
+inline int ImplRandPermSize(int handle) {
+    FeistelPermutation* perm = PermutationPool().Get(handle);
+    return perm ? static_cast<int>(perm->Domain()) : 0;
+}
+
+inline bool ImplRandPermDestroy(int handle) {
+    return PermutationPool().Remove(handle);
+}
+
+// RandUniqueCode - RandFormat pattern whose code space is walked by a keyed
+// permutation, so distinct counters always give distinct codes
+
+struct UniqueCodePattern {
+    std::vector<PatternSlot> slots;
+    std::unique_ptr<FeistelPermutation> permutation;
+};
+
+inline HandlePool<UniqueCodePattern>& UniqueCodePool() {
+    static HandlePool<UniqueCodePattern> pool;
+    return pool;
+}
+
+inline int CreateUniqueCode(const char* pattern, const uint32_t* key) {
+    auto code = std::make_unique<UniqueCodePattern>();
+    uint64_t space;
+    ParsePattern(pattern, code->slots, space);
+    if (space > (1ULL << 62)) return 0;
+    
+    code->permutation = std::make_unique<FeistelPermutation>(space, key);
+    return UniqueCodePool().Add(std::move(code));
+}
+
+// A nonzero seed gives only 2^32 keys: reproducible, not unpredictable
+inline int ImplRandUniqueCodeCreate(const char* pattern, uint32_t seed) {
+    if (pattern == nullptr) return 0;
+    
+    uint32_t key[8];
+    DeriveKey(seed, 0x55434F44, key);
+    int handle = CreateUniqueCode(pattern, key);
+    std::fill(key, key + 8, 0);
+    return handle;
+}
+
+// Persistent and unpredictable: the key comes from a secret of 16+ characters
+inline int ImplRandUniqueCodeCreateKeyed(const char* pattern, const char* secret) {
+    if (pattern == nullptr || secret == nullptr) return 0;
+    size_t len = std::strlen(secret);
+    if (len < 16) return 0;
+    
+    uint32_t key[8];
+    DeriveKeyFromSecret(secret, len, 0x55434F44, key);
+    int handle = CreateUniqueCode(pattern, key);
+    std::fill(key, key + 8, 0);
+    return handle;
+}
+
+template<typename CharT>
+inline bool ImplRandUniqueCode(int handle, int counter, CharT* dest, int destSize) {
+    UniqueCodePattern* code = UniqueCodePool().Get(handle);
+    if (code == nullptr || dest == nullptr) return false;
+    if (static_cast<int>(code->slots.size()) >= destSize) return false;
+    if (counter < 0 || static_cast<uint64_t>(counter) >= code->permutation->Domain()) return false;
+    
+    uint64_t value = code->permutation->Permute(static_cast<uint64_t>(counter));
+    
+    // Mixed-radix digits, least significant in the rightmost slot
+    int len = static_cast<int>(code->slots.size());
+    for (int i = len - 1; i >= 0; i--) {
+        const auto& slot = code->slots[i];
+        if (slot.charset) {
+            dest[i] = static_cast<CharT>(slot.charset[value % slot.radix]);
+            value /= slot.radix;
+        }
+    }
+    
+    char text[256];
+    for (int i = 0; i < len; i++) {
+        const auto& slot = code->slots[i];
+        if (slot.check >= 0) {
+            int textLen = std::min(i, 255);
+            for (int j = 0; j < textLen; j++) text[j] = static_cast<char>(dest[j]);
+            dest[i] = static_cast<CharT>(ComputeCheckSymbol(text, textLen, static_cast<CheckAlgorithm>(slot.check)));
+        } else if (!slot.charset) {
+            dest[i] = static_cast<CharT>(slot.literal);
+        }
+    }
+    dest[len] = 0;
+    
+    return true;
+}
+
+inline int ImplRandUniqueCodeSpace(int handle) {
+    UniqueCodePattern* code = UniqueCodePool().Get(handle);
+    if (code == nullptr) return 0;
+    uint64_t space = code->permutation->Domain();
+    return static_cast<int>(std::min<uint64_t>(space, INT_MAX));
+}
+
+inline bool ImplRandUniqueCodeDestroy(int handle) {
+    return UniqueCodePool().Remove(handle);
+}
+
+// Token registry - "has this code been issued?" without a database round trip.
+// A cuckoo filter (16-bit fingerprints, 4-slot buckets, ~0.01% false
+// positives) answers most queries; the optional exact set stores the tokens
+// themselves in an open-addressing table so answers are never wrong.
+
+class TokenRegistry {
+private:
+    static constexpr int BUCKET_SLOTS = 4;
+    static constexpr int MAX_KICKS = 500;
+    static constexpr uint32_t EMPTY = 0;
+    static constexpr uint32_t TOMBSTONE = UINT32_MAX;
+    
+    struct ExactSlot {
+        uint32_t tag;      // High hash bits, cheap pre-compare
+        uint32_t offset;   // Into arena_; EMPTY or TOMBSTONE when unused
+    };
+    
+    std::vector<uint16_t> buckets_;
+    uint32_t bucketMask_ = 0;
+    uint16_t victimFp_ = 0;
+    uint32_t victimIndex_ = 0;
+    uint32_t count_ = 0;
+    
+    bool exact_ = false;
+    std::vector<ExactSlot> slots_;
+    std::string arena_;    // Length-prefixed tokens; offset 0 is a sentinel
+    uint32_t used_ = 0;    // Live + tombstoned slots
+    
+    static uint16_t Fingerprint(uint64_t hash) {
+        uint16_t fp = static_cast<uint16_t>(hash >> 48);
+        return fp ? fp : 1;
+    }
+    
+    uint32_t AltIndex(uint32_t index, uint16_t fp) const {
+        return (index ^ static_cast<uint32_t>(fp * 0x5BD1E995u)) & bucketMask_;
+    }
+    
+    bool BucketHas(uint32_t index, uint16_t fp) const {
+        const uint16_t* b = &buckets_[index * BUCKET_SLOTS];
+        return b[0] == fp || b[1] == fp || b[2] == fp || b[3] == fp;
+    }
+    
+    bool BucketInsert(uint32_t index, uint16_t fp) {
+        uint16_t* b = &buckets_[index * BUCKET_SLOTS];
+        for (int i = 0; i < BUCKET_SLOTS; i++) {
+            if (b[i] == 0) {
+                b[i] = fp;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    bool BucketErase(uint32_t index, uint16_t fp) {
+        uint16_t* b = &buckets_[index * BUCKET_SLOTS];
+        for (int i = 0; i < BUCKET_SLOTS; i++) {
+            if (b[i] == fp) {
+                b[i] = 0;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    bool FilterContains(uint64_t hash) const {
+        uint16_t fp = Fingerprint(hash);
+        uint32_t i1 = static_cast<uint32_t>(hash) & bucketMask_;
+        uint32_t i2 = AltIndex(i1, fp);
+        if (victimFp_ == fp && (victimIndex_ == i1 || victimIndex_ == i2)) return true;
+        return BucketHas(i1, fp) || BucketHas(i2, fp);
+    }
+    
+    bool FilterInsert(uint64_t hash) {
+        if (victimFp_ != 0) return false;
+        
+        uint16_t fp = Fingerprint(hash);
+        uint32_t i1 = static_cast<uint32_t>(hash) & bucketMask_;
+        uint32_t i2 = AltIndex(i1, fp);
+        if (BucketInsert(i1, fp) || BucketInsert(i2, fp)) return true;
+        
+        // Evict random residents; the last homeless fingerprint is stashed
+        // in the victim slot so nothing is ever lost
+        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+        auto& rng = Randomix::GetRNG();
+        uint32_t index = (rng.next_uint32() & 1) ? i1 : i2;
+        for (int kick = 0; kick < MAX_KICKS; kick++) {
+            uint16_t& slot = buckets_[index * BUCKET_SLOTS + rng.next_bounded(BUCKET_SLOTS)];
+            std::swap(fp, slot);
+            index = AltIndex(index, fp);
+            if (BucketInsert(index, fp)) return true;
+        }
+        victimFp_ = fp;
+        victimIndex_ = index;
+        return true;
+    }
+    
+    bool FilterErase(uint64_t hash) {
+        uint16_t fp = Fingerprint(hash);
+        uint32_t i1 = static_cast<uint32_t>(hash) & bucketMask_;
+        uint32_t i2 = AltIndex(i1, fp);
+        if (BucketErase(i1, fp) || BucketErase(i2, fp)) {
+            // Give the stashed victim a home again
+            if (victimFp_ != 0) {
+                uint16_t victim = victimFp_;
+                victimFp_ = 0;
+                if (!BucketInsert(victimIndex_, victim) && !BucketInsert(AltIndex(victimIndex_, victim), victim)) {
+                    victimFp_ = victim;
+                }
+            }
+            return true;
+        }
+        if (victimFp_ == fp && (victimIndex_ == i1 || victimIndex_ == i2)) {
+            victimFp_ = 0;
+            return true;
+        }
+        return false;
+    }
     
-    float u1 = Randomix::GetRNG().next_float();
-    float u2 = Randomix::GetRNG().next_float();
-    if (u1 < 1e-10f) u1 = 1e-10f;
+    bool TokenAt(uint32_t offset, const char* token, uint32_t len) const {
+        uint32_t stored;
+        std::memcpy(&stored, arena_.data() + offset, sizeof(stored));
+        return stored == len && std::memcmp(arena_.data() + offset + sizeof(stored), token, len) == 0;
+    }
     
-    float z0 = std::sqrt(-2.0f * std::log(u1)) * std::cos(TWO_PI * u2);
-    float result = mean + z0 * stddev;
+    // Index of the slot holding the token, or -1
+    int64_t ExactFind(uint64_t hash, const char* token, uint32_t len) const {
+        if (slots_.empty()) return -1;
+        uint32_t mask = static_cast<uint32_t>(slots_.size()) - 1;
+        uint32_t tag = static_cast<uint32_t>(hash >> 32);
+        for (uint32_t i = static_cast<uint32_t>(hash) & mask;; i = (i + 1) & mask) {
+            const ExactSlot& slot = slots_[i];
+            if (slot.offset == EMPTY) return -1;
+            if (slot.offset != TOMBSTONE && slot.tag == tag && TokenAt(slot.offset, token, len)) return i;
+        }
+    }
     
-    return static_cast<int>(result < 0.0f ? 0.0f : result);
-}
-
-inline int ImplRandDice(int sides, int count) {
-    if (sides <= 0 || count <= 0) return 0;
-    if (sides > 10000 || count > 10000) return 0;
+    void ExactPlace(uint64_t hash, uint32_t offset) {
+        uint32_t mask = static_cast<uint32_t>(slots_.size()) - 1;
+        uint32_t i = static_cast<uint32_t>(hash) & mask;
+        while (slots_[i].offset != EMPTY && slots_[i].offset != TOMBSTONE) i = (i + 1) & mask;
+        if (slots_[i].offset == EMPTY) used_++;
+        slots_[i] = { static_cast<uint32_t>(hash >> 32), offset };
+    }
     
-    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
-    uint32_t total = 0;
-    uint32_t uSides = static_cast<uint32_t>(sides);
+    // Rebuild the table from the arena (drops tombstones, keeps load <= 50%)
+    void ExactRehash(size_t minLive) {
+        size_t size = 16;
+        while (size < minLive * 2) size <<= 1;
+        slots_.assign(size, ExactSlot { 0, EMPTY });
+        used_ = 0;
+        
+        std::string old;
+        old.swap(arena_);
+        arena_.assign(1, '\0');
+        for (size_t pos = 1; pos + sizeof(uint32_t) <= old.size();) {
+            uint32_t len;
+            std::memcpy(&len, old.data() + pos, sizeof(len));
+            bool live = (len & 0x80000000u) == 0;
+            len &= 0x7FFFFFFFu;
+            if (pos + sizeof(len) + len > old.size()) break;
+            if (live) ExactStore(old.data() + pos + sizeof(len), len);
+            pos += sizeof(len) + len;
+        }
+    }
     
-    for (int i = 0; i < count; i++) {
-        total += Randomix::GetRNG().next_bounded(uSides) + 1;
+    // Walks arena records as read from a file; false if a record runs past
+    // the end. `live` receives the number of records not marked removed.
+    static bool CheckArena(const std::string& arena, uint32_t& live) {
+        live = 0;
+        size_t pos = 1;
+        while (pos < arena.size()) {
+            uint32_t len;
+            if (pos + sizeof(len) > arena.size()) return false;
+            std::memcpy(&len, arena.data() + pos, sizeof(len));
+            if ((len & 0x80000000u) == 0) live++;
+            len &= 0x7FFFFFFFu;
+            if (len > arena.size() - pos - sizeof(len)) return false;
+            pos += sizeof(len) + len;
+        }
+        return true;
     }
     
-    return static_cast<int>(total);
-}
-
-inline int ImplRandPick(const int* array, int count) {
-    if (count <= 0 || array == nullptr) return 0;
+    void ExactStore(const char* token, uint32_t len) {
+        uint32_t offset = static_cast<uint32_t>(arena_.size());
+        arena_.append(reinterpret_cast<const char*>(&len), sizeof(len));
+        arena_.append(token, len);
+        ExactPlace(HashString(token, len), offset);
+    }
     
-    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
-    uint32_t idx = Randomix::GetRNG().next_bounded(static_cast<uint32_t>(count));
-    return array[idx];
-}
-
-// String & token functions
-
-inline bool ImplRandFormat(char* dest, const char* pattern, int destSize) {
-    if (destSize <= 0 || dest == nullptr || pattern == nullptr) return false;
-    if (destSize > 65536) return false;
+public:
+    TokenRegistry(uint32_t capacity, bool exact) : exact_(exact) {
+        uint32_t buckets = 1;
+        while (buckets * BUCKET_SLOTS * 95ULL / 100 < capacity) buckets <<= 1;
+        buckets_.assign(static_cast<size_t>(buckets) * BUCKET_SLOTS, 0);
+        bucketMask_ = buckets - 1;
+        if (exact_) ExactRehash(0);
+    }
     
-    static const char* upper = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-    static const char* lower = "abcdefghijklmnopqrstuvwxyz";
-    static const char* digit = "0123456789";
-    static const char* alpha = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
-    static const char* symbol = "!@#$%^&*()_+-=[]{}|;:,.<>?";
+    uint32_t Count() const { return count_; }
+    bool IsExact() const { return exact_; }
     
-    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
-    auto& rng = Randomix::GetRNG();
+    bool Contains(const char* token, uint32_t len) const {
+        uint64_t hash = HashString(token, len);
+        if (!FilterContains(hash)) return false;
+        return !exact_ || ExactFind(hash, token, len) >= 0;
+    }
     
-    int outPos = 0;
-    int patternLen = static_cast<int>(std::strlen(pattern));
+    // 1 = added, 0 = already present (or a filter false positive), -1 = full
+    int Add(const char* token, uint32_t len) {
+        if (Contains(token, len)) return 0;
+        
+        uint64_t hash = HashString(token, len);
+        if (!FilterInsert(hash)) return -1;
+        if (exact_) {
+            if ((used_ + 1) * 2 > slots_.size()) ExactRehash(count_ + 1);
+            ExactStore(token, len);
+        }
+        count_++;
+        return 1;
+    }
     
-    for (int i = 0; i < patternLen && outPos < destSize - 1; i++) {
-        char c = pattern[i];
-        const char* charset = nullptr;
-        size_t len = 0;
+    // Filter-only registries can only remove tokens that were really added
+    bool Remove(const char* token, uint32_t len) {
+        uint64_t hash = HashString(token, len);
+        if (exact_) {
+            int64_t index = ExactFind(hash, token, len);
+            if (index < 0) return false;
+            // Mark the arena record dead so rehashing skips it
+            uint32_t offset = slots_[index].offset;
+            uint32_t stored;
+            std::memcpy(&stored, arena_.data() + offset, sizeof(stored));
+            stored |= 0x80000000u;
+            std::memcpy(&arena_[offset], &stored, sizeof(stored));
+            slots_[index].offset = TOMBSTONE;
+        }
+        if (!FilterErase(hash)) return false;
+        count_--;
+        return true;
+    }
+    
+    // Binary layout: magic, version, flags, bucket count, count, victim,
+    // fingerprint buckets, then (exact only) arena size and arena bytes
+    bool Save(const char* path) const {
+        std::string tmp = std::string(path) + ".tmp";
+        FILE* f = std::fopen(tmp.c_str(), "wb");
+        if (!f) return false;
         
-        switch (c) {
-            case 'X': charset = upper; len = 26; break;
-            case 'x': charset = lower; len = 26; break;
-            case '9': charset = digit; len = 10; break;
-            case 'A': charset = alpha; len = 62; break;
-            case '!': charset = symbol; len = 25; break;
-            default:
-                if (c == '\\' && i + 1 < patternLen) {
-                    i++;
-                    dest[outPos++] = pattern[i];
-                } else {
-                    dest[outPos++] = c;
-                }
-                continue;
+        uint32_t header[6] = { 0x58444E52, 1, exact_ ? 1u : 0u, bucketMask_ + 1, count_,
+            (static_cast<uint32_t>(victimFp_) << 16) };
+        uint32_t victimIndex = victimIndex_;
+        bool ok = std::fwrite(header, sizeof(header), 1, f) == 1
+            && std::fwrite(&victimIndex, sizeof(victimIndex), 1, f) == 1
+            && std::fwrite(buckets_.data(), sizeof(uint16_t), buckets_.size(), f) == buckets_.size();
+        if (ok && exact_) {
+            uint64_t arenaSize = arena_.size();
+            ok = std::fwrite(&arenaSize, sizeof(arenaSize), 1, f) == 1
+                && std::fwrite(arena_.data(), 1, arena_.size(), f) == arena_.size();
         }
+        ok = (std::fclose(f) == 0) && ok;
         
-        if (charset && len > 0) {
-            uint32_t idx = rng.next_bounded(static_cast<uint32_t>(len));
-            dest[outPos++] = charset[idx];
+        if (!ok) {
+            std::remove(tmp.c_str());
+            return false;
         }
+        // Never leaves a moment without a registry file on disk
+        if (AtomicReplaceFile(tmp.c_str(), path)) return true;
+        std::remove(tmp.c_str());
+        return false;
     }
     
-    dest[outPos] = '\0';
-    return true;
+    static std::unique_ptr<TokenRegistry> Load(const char* path) {
+        FILE* f = std::fopen(path, "rb");
+        if (!f) return nullptr;
+        
+        uint32_t header[6];
+        uint32_t victimIndex;
+        std::unique_ptr<TokenRegistry> reg;
+        
+        if (std::fread(header, sizeof(header), 1, f) == 1
+            && std::fread(&victimIndex, sizeof(victimIndex), 1, f) == 1
+            && header[0] == 0x58444E52 && header[1] == 1
+            && header[3] != 0 && (header[3] & (header[3] - 1)) == 0 && header[3] <= (1u << 26)
+            && victimIndex < header[3]
+            && header[4] <= static_cast<uint64_t>(header[3]) * BUCKET_SLOTS + 1) {
+            reg = std::make_unique<TokenRegistry>(1, header[2] != 0);
+            reg->buckets_.assign(static_cast<size_t>(header[3]) * BUCKET_SLOTS, 0);
+            reg->bucketMask_ = header[3] - 1;
+            reg->count_ = header[4];
+            reg->victimFp_ = static_cast<uint16_t>(header[5] >> 16);
+            reg->victimIndex_ = victimIndex;
+            
+            bool ok = std::fread(reg->buckets_.data(), sizeof(uint16_t), reg->buckets_.size(), f) == reg->buckets_.size();
+            if (ok && reg->exact_) {
+                uint64_t arenaSize = 0;
+                ok = std::fread(&arenaSize, sizeof(arenaSize), 1, f) == 1 && arenaSize >= 1 && arenaSize < 0xFFFFFFF0ULL;
+                if (ok) {
+                    reg->arena_.resize(static_cast<size_t>(arenaSize));
+                    ok = std::fread(&reg->arena_[0], 1, reg->arena_.size(), f) == reg->arena_.size();
+                }
+                // The header count must match the arena, never size the table alone
+                uint32_t live = 0;
+                ok = ok && CheckArena(reg->arena_, live) && live == reg->count_;
+                if (ok) reg->ExactRehash(live);
+            }
+            if (!ok) reg.reset();
+        }
+        
+        std::fclose(f);
+        return reg;
+    }
+};
+
+inline HandlePool<TokenRegistry>& RegistryPool() {
+    static HandlePool<TokenRegistry> pool;
+    return pool;
 }
 
-inline bool ImplRandBytes(uint8_t* buffer, int length) {
-    if (length <= 0 || buffer == nullptr) return false;
-    if (length > 65536) return false;
-    
-    std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
-    
-    for (int i = 0; i < length; i++) {
-        buffer[i] = static_cast<uint8_t>(Randomix::GetRNG().next_uint32() & 0xFF);
-    }
-    return true;
+inline int ImplRandRegistryCreate(int capacity, bool exact) {
+    if (capacity <= 0 || capacity > 100000000) return 0;
+    return RegistryPool().Add(std::make_unique<TokenRegistry>(static_cast<uint32_t>(capacity), exact));
 }
 
-inline bool ImplRandUUID(char* out) {
-    if (out == nullptr) return false;
-    
-    uint8_t bytes[16];
-    {
-        std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
-        Randomix::GetRNG().next_bytes(bytes, 16);
-    }
-    
-    bytes[6] = (bytes[6] & 0x0F) | 0x40;
-    bytes[8] = (bytes[8] & 0x3F) | 0x80;
-    
-    static const char* hex = "0123456789abcdef";
-    int p = 0;
+inline int ImplRandRegistryAdd(int handle, const char* token) {
+    TokenRegistry* reg = RegistryPool().Get(handle);
+    if (reg == nullptr || token == nullptr) return -1;
+    return reg->Add(token, static_cast<uint32_t>(std::strlen(token)));
+}
+
+inline bool ImplRandRegistryContains(int handle, const char* token) {
+    TokenRegistry* reg = RegistryPool().Get(handle);
+    if (reg == nullptr || token == nullptr) return false;
+    return reg->Contains(token, static_cast<uint32_t>(std::strlen(token)));
+}
+
+inline bool ImplRandRegistryRemove(int handle, const char* token) {
+    TokenRegistry* reg = RegistryPool().Get(handle);
+    if (reg == nullptr || token == nullptr) return false;
+    return reg->Remove(token, static_cast<uint32_t>(std::strlen(token)));
+}
+
+inline int ImplRandRegistryCount(int handle) {
+    TokenRegistry* reg = RegistryPool().Get(handle);
+    return reg ? static_cast<int>(reg->Count()) : 0;
+}
+
+inline bool ImplRandRegistrySave(int handle, const char* filename) {
+    TokenRegistry* reg = RegistryPool().Get(handle);
+    std::string path;
+    if (reg == nullptr || !ScriptFilePath(filename, path)) return false;
+    return reg->Save(path.c_str());
+}
+
+inline int ImplRandRegistryLoad(const char* filename) {
+    std::string path;
+    if (!ScriptFilePath(filename, path)) return 0;
+    return RegistryPool().Add(TokenRegistry::Load(path.c_str()));
+}
+
+inline bool ImplRandRegistryDestroy(int handle) {
+    return RegistryPool().Remove(handle);
+}
+
+// Generate RandFormat codes until one is not in the registry, then record it
+inline bool ImplRandFormatUnique(int handle, char* dest, const char* pattern, int destSize, int maxAttempts) {
+    TokenRegistry* reg = RegistryPool().Get(handle);
+    if (reg == nullptr) return false;
+    if (maxAttempts <= 0 || maxAttempts > 10000) return false;
     
-    for (int i = 0; i < 16; i++) {
-        out[p++] = hex[bytes[i] >> 4];
-        out[p++] = hex[bytes[i] & 0xF];
-        if (i == 3 || i == 5 || i == 7 || i == 9)
-            out[p++] = '-';
+    for (int attempt = 0; attempt < maxAttempts; attempt++) {
+        if (!ImplRandFormat(dest, pattern, destSize, true)) return false;
+        int result = reg->Add(dest, static_cast<uint32_t>(std::strlen(dest)));
+        if (result == 1) return true;
+        if (result < 0) return false;
     }
-    out[p] = '\0';
-    return true;
+    return false;
 }
 
 // 2D geometry functions
@@ -526,3 +4180,528 @@ inline bool ImplRandPointInPolygon(const float* vertices, int vertexCount, float
     
     return true;
 }
+
+// RandPoissonDisk - Bridson's algorithm: points in a rectangle, no two closer
+// than minDist, O(n) with a background grid of cell size minDist / sqrt(2).
+// Returns the number of points written (at most maxPoints).
+
+inline int PoissonDisk(SubStream& rng, float minX, float minY, float maxX, float maxY,
+                       float minDist, int maxPoints, float* outX, float* outY) {
+    if (minX > maxX) std::swap(minX, maxX);
+    if (minY > maxY) std::swap(minY, maxY);
+    if (!CheckFloatRangeValid(minX, maxX) || !CheckFloatRangeValid(minY, maxY)) return 0;
+    if (std::isinf(minX) || std::isinf(maxX) || std::isinf(minY) || std::isinf(maxY)) return 0;
+    if (!CheckPositive(minDist) || maxPoints <= 0) return 0;
+    
+    const float width = maxX - minX, height = maxY - minY;
+    const float cellSize = minDist / 1.41421356f;
+    const double gw = std::ceil(width / cellSize) + 1.0, gh = std::ceil(height / cellSize) + 1.0;
+    if (gw * gh > 16777216.0) return 0;
+    const int gridW = static_cast<int>(gw), gridH = static_cast<int>(gh);
+    
+    std::vector<int32_t> grid(static_cast<size_t>(gridW) * gridH, -1);
+    std::vector<int32_t> active;
+    const float minDistSq = minDist * minDist;
+    int count = 0;
+    
+    auto place = [&](float x, float y) {
+        int gx = static_cast<int>((x - minX) / cellSize);
+        int gy = static_cast<int>((y - minY) / cellSize);
+        outX[count] = x;
+        outY[count] = y;
+        grid[static_cast<size_t>(gy) * gridW + gx] = count;
+        active.push_back(count);
+        count++;
+    };
+    
+    auto fits = [&](float x, float y) {
+        if (x < minX || x > maxX || y < minY || y > maxY) return false;
+        int gx = static_cast<int>((x - minX) / cellSize);
+        int gy = static_cast<int>((y - minY) / cellSize);
+        for (int yy = std::max(0, gy - 2); yy <= std::min(gridH - 1, gy + 2); yy++) {
+            for (int xx = std::max(0, gx - 2); xx <= std::min(gridW - 1, gx + 2); xx++) {
+                int32_t other = grid[static_cast<size_t>(yy) * gridW + xx];
+                if (other < 0) continue;
+                float dx = outX[other] - x, dy = outY[other] - y;
+                if (dx * dx + dy * dy < minDistSq) return false;
+            }
+        }
+        return true;
+    };
+    
+    place(minX + rng.NextFloat() * width, minY + rng.NextFloat() * height);
+    
+    while (!active.empty() && count < maxPoints) {
+        uint32_t slot = rng.Bounded(static_cast<uint32_t>(active.size()));
+        int32_t from = active[slot];
+        bool placed = false;
+        
+        for (int attempt = 0; attempt < 30 && count < maxPoints; attempt++) {
+            // Uniform over the annulus [minDist, 2 * minDist)
+            float angle = rng.NextFloat() * TWO_PI;
+            float radius = std::sqrt(minDistSq * (1.0f + 3.0f * rng.NextFloat()));
+            float x = outX[from] + radius * std::cos(angle);
+            float y = outY[from] + radius * std::sin(angle);
+            if (fits(x, y)) {
+                place(x, y);
+                placed = true;
+                break;
+            }
+        }
+        
+        if (!placed) {
+            active[slot] = active.back();
+            active.pop_back();
+        }
+    }
+    return count;
+}
+
+inline int ImplRandPoissonDisk(float minX, float minY, float maxX, float maxY, float minDist,
+                               float* outX, float* outY, int maxPoints, uint32_t seed) {
+    if (outX == nullptr || outY == nullptr) return 0;
+    uint32_t key[8];
+    DeriveKey(seed, 0x506F6973, key);
+    SubStream rng(key);
+    std::fill(key, key + 8, 0);
+    return PoissonDisk(rng, minX, minY, maxX, maxY, minDist, maxPoints, outX, outY);
+}
+
+// Async jobs
+// Heavy generators run on a small worker pool. Each job owns its input and
+// result buffers (scripts never share AMX memory with a worker) and draws
+// from its own SubStream: keyed from the global RNG, or derived from a
+// nonzero seed so the same seed always gives the same result. Completion
+// queues OnRandJobDone(job, resultCount) for the owning script; the job
+// handle is released after that callback returns.
+
+class WorkerPool {
+private:
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::atomic<bool> stopFlag_{false};     // Lock-free copy of stopping_ for running tasks
+    
+public:
+    explicit WorkerPool(unsigned count) {
+        for (unsigned i = 0; i < count; i++) {
+            threads_.emplace_back([this] {
+                for (;;) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        wake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                        if (tasks_.empty()) return;
+                        task = std::move(tasks_.front());
+                        tasks_.pop_front();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+    
+    ~WorkerPool() { Shutdown(); }
+    
+    // Drops queued tasks and joins the threads (running tasks finish first;
+    // long ones poll Stopping()). Safe to call more than once.
+    void Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            tasks_.clear();
+        }
+        stopFlag_ = true;
+        wake_.notify_all();
+        for (auto& t : threads_) {
+            if (t.joinable()) t.join();
+        }
+        threads_.clear();
+    }
+    
+    bool Stopping() const { return stopFlag_; }
+    
+    void Submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) return;
+            tasks_.push_back(std::move(task));
+        }
+        wake_.notify_one();
+    }
+};
+
+// Created on first use and shut down explicitly when the plugin unloads:
+// joining threads from a static destructor can deadlock under the Windows
+// loader lock.
+inline std::unique_ptr<WorkerPool>& WorkerPoolInstance() {
+    PendingCallbacks();   // Constructed first so it outlives the workers
+    static std::unique_ptr<WorkerPool> pool;
+    return pool;
+}
+
+inline WorkerPool& Workers() {
+    auto& pool = WorkerPoolInstance();
+    if (!pool) pool = std::make_unique<WorkerPool>(std::max(1u, std::min(4u, std::thread::hardware_concurrency() / 2)));
+    return *pool;
+}
+
+inline void ShutdownWorkers() {
+    auto& pool = WorkerPoolInstance();
+    if (pool) pool->Shutdown();
+}
+
+struct AsyncJob {
+    void* owner;
+    std::mutex mutex;          // Guards cancelled vs. completion
+    bool cancelled = false;
+    std::atomic<bool> done{false};
+    std::vector<int32_t> ints;
+    std::vector<float> xs, ys;
+    int resultCount = 0;
+    uint32_t key[8];
+};
+
+struct AsyncJobSlot {
+    std::shared_ptr<AsyncJob> job;
+};
+
+inline HandlePool<AsyncJobSlot>& AsyncJobPool() {
+    static HandlePool<AsyncJobSlot> pool;
+    return pool;
+}
+
+inline AsyncJob* GetAsyncJob(int handle) {
+    AsyncJobSlot* slot = AsyncJobPool().Get(handle);
+    return slot ? slot->job.get() : nullptr;
+}
+
+// Registers the job and hands `work` to the pool; `work` fills the result
+// buffers and returns the result count
+inline int StartAsyncJob(std::shared_ptr<AsyncJob> job, uint32_t seed, uint32_t domain,
+                         std::function<int(AsyncJob&, SubStream&)> work) {
+    if (Workers().Stopping()) return 0;
+    DeriveKey(seed, domain, job->key);
+    int handle = AsyncJobPool().Add(std::make_unique<AsyncJobSlot>(AsyncJobSlot{job}));
+    if (!handle) return 0;
+    
+    Workers().Submit([job, handle, work = std::move(work)] {
+        SubStream rng(job->key);
+        int count = work(*job, rng);
+        
+        std::lock_guard<std::mutex> lock(job->mutex);
+        if (job->cancelled) return;
+        job->resultCount = count;
+        job->done = true;
+        
+        std::weak_ptr<AsyncJob> weak = job;
+        PendingCallbacks().Push({job->owner, "OnRandJobDone", {handle, count}, [weak, handle] {
+            // Only release the slot if it still holds this job
+            AsyncJobSlot* slot = AsyncJobPool().Get(handle);
+            if (slot && slot->job == weak.lock()) AsyncJobPool().Remove(handle);
+        }});
+    });
+    return handle;
+}
+
+inline int ImplRandShuffleAsync(void* owner, const int32_t* array, int count, uint32_t seed) {
+    if (array == nullptr || count <= 0) return 0;
+    
+    auto job = std::make_shared<AsyncJob>();
+    job->owner = owner;
+    job->ints.assign(array, array + count);
+    return StartAsyncJob(job, seed, 0x53687566, [](AsyncJob& j, SubStream& rng) {
+        for (size_t i = j.ints.size(); i > 1; i--) {
+            if ((i & 0xFFFF) == 0 && Workers().Stopping()) return 0;
+            std::swap(j.ints[i - 1], j.ints[rng.Bounded(static_cast<uint32_t>(i))]);
+        }
+        return static_cast<int>(j.ints.size());
+    });
+}
+
+inline int ImplRandPoissonDiskAsync(void* owner, float minX, float minY, float maxX, float maxY,
+                                    float minDist, int maxPoints, uint32_t seed) {
+    if (maxPoints <= 0 || maxPoints > 1000000) return 0;
+    
+    auto job = std::make_shared<AsyncJob>();
+    job->owner = owner;
+    return StartAsyncJob(job, seed, 0x506F6973, [=](AsyncJob& j, SubStream& rng) {
+        j.xs.resize(static_cast<size_t>(maxPoints));
+        j.ys.resize(static_cast<size_t>(maxPoints));
+        int count = PoissonDisk(rng, minX, minY, maxX, maxY, minDist, maxPoints, j.xs.data(), j.ys.data());
+        j.xs.resize(static_cast<size_t>(count));
+        j.ys.resize(static_cast<size_t>(count));
+        return count;
+    });
+}
+
+// Copies integer results; returns cells copied, -1 if not finished/invalid
+inline int ImplRandJobFetch(int handle, int32_t* dest, int maxCount, int offset) {
+    AsyncJob* job = GetAsyncJob(handle);
+    if (job == nullptr || !job->done || dest == nullptr || offset < 0) return -1;
+    if (static_cast<size_t>(offset) >= job->ints.size()) return 0;
+    
+    int available = static_cast<int>(job->ints.size()) - offset;
+    int n = std::max(0, std::min(available, maxCount));
+    std::copy(job->ints.begin() + offset, job->ints.begin() + offset + n, dest);
+    return n;
+}
+
+inline int ImplRandJobFetchPoints(int handle, float* outX, float* outY, int maxCount) {
+    AsyncJob* job = GetAsyncJob(handle);
+    if (job == nullptr || !job->done || outX == nullptr || outY == nullptr) return -1;
+    
+    int n = std::max(0, std::min(static_cast<int>(job->xs.size()), maxCount));
+    std::copy(job->xs.begin(), job->xs.begin() + n, outX);
+    std::copy(job->ys.begin(), job->ys.begin() + n, outY);
+    return n;
+}
+
+inline bool ImplRandJobDone(int handle) {
+    AsyncJob* job = GetAsyncJob(handle);
+    return job != nullptr && job->done;
+}
+
+inline bool ImplRandJobCancel(int handle) {
+    AsyncJobSlot* slot = AsyncJobPool().Get(handle);
+    if (slot == nullptr) return false;
+    {
+        std::lock_guard<std::mutex> lock(slot->job->mutex);
+        slot->job->cancelled = true;
+    }
+    return AsyncJobPool().Remove(handle);
+}
+
+// RandEvent - recurring random events. Each event re-arms itself with a gap
+// drawn from its inter-arrival distribution (exponential = Poisson process,
+// uniform, or a weighted list of delays) and queues its named public,
+// `callback(event, arg)`, for the owning script. Due times live on a hashed
+// timer wheel: 1024 slots of 10 ms, so arming is O(1) and a tick only visits
+// the slots that elapsed; gaps beyond one revolution (10.24 s) stay in their
+// slot and are skipped until their turn comes round.
+
+enum class EventGap { Exponential, Uniform, Custom };
+
+struct RandEvent {
+    void* owner;
+    std::string callback;
+    int32_t arg;
+    EventGap kind;
+    double a, b;                    // Mean, or min/max in ms
+    std::vector<int32_t> delays;    // Custom delays, picked through `alias`
+    AliasTable alias;
+    int32_t remaining;              // Fires left, 0 = unlimited
+    uint64_t serial;
+    int64_t due = 0;
+    bool finished = false;
+    
+    // Caller must hold rng_mutex
+    int64_t NextGap(ChaChaRNG& rng) const {
+        double gap;
+        switch (kind) {
+            case EventGap::Exponential:
+                gap = -a * std::log(1.0 - NextUnitDouble(rng));
+                break;
+            case EventGap::Uniform:
+                gap = a + static_cast<double>(rng.next_bounded(static_cast<uint32_t>(b - a) + 1));
+                break;
+            default:
+                gap = delays[alias.Sample(rng)];
+                break;
+        }
+        return static_cast<int64_t>(std::min(std::max(gap, 1.0), 2147483647.0));
+    }
+};
+
+class EventScheduler {
+private:
+    static constexpr int64_t RESOLUTION_MS = 10;
+    static constexpr size_t SLOTS = 1024;
+    static constexpr int64_t STALL_MS = 100;    // Lateness beyond this re-arms from now
+    
+    struct Entry {
+        int handle;
+        uint64_t serial;
+        int64_t due;
+    };
+    
+    HandlePool<RandEvent> events_;
+    std::vector<std::vector<Entry>> wheel_;
+    int64_t cursor_;                // Start time of the next slot to process
+    uint64_t nextSerial_ = 1;
+    
+    static int64_t NowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+    void Insert(const Entry& entry) {
+        int64_t when = std::max(entry.due, cursor_);
+        wheel_[static_cast<size_t>(when / RESOLUTION_MS) & (SLOTS - 1)].push_back(entry);
+    }
+    
+    void Arm(int handle, RandEvent& event, int64_t from) {
+        {
+            std::lock_guard<std::mutex> lock(Randomix::rng_mutex);
+            event.due = from + event.NextGap(Randomix::GetRNG());
+        }
+        Insert({handle, event.serial, event.due});
+    }
+    
+    void Fire(int handle, RandEvent& event, int64_t now) {
+        uint64_t serial = event.serial;
+        if (event.remaining > 0 && --event.remaining == 0) {
+            // Keep the handle valid until the last callback has run
+            event.finished = true;
+            PendingCallbacks().Push({event.owner, event.callback, {handle, event.arg}, [this, handle, serial] {
+                RandEvent* e = events_.Get(handle);
+                if (e && e->serial == serial) events_.Remove(handle);
+            }});
+            return;
+        }
+        PendingCallbacks().Push({event.owner, event.callback, {handle, event.arg}});
+        // Re-arm from the scheduled time so slot rounding does not stretch the
+        // process; after a stall, resume from now instead of bursting
+        Arm(handle, event, std::max(event.due, now - STALL_MS));
+    }
+    
+public:
+    EventScheduler() : wheel_(SLOTS), cursor_(NowMs() / RESOLUTION_MS * RESOLUTION_MS) {}
+    
+    int Start(std::unique_ptr<RandEvent> event) {
+        event->serial = nextSerial_++;
+        RandEvent* raw = event.get();
+        int handle = events_.Add(std::move(event));
+        if (handle) Arm(handle, *raw, NowMs());
+        return handle;
+    }
+    
+    RandEvent* Get(int handle) const {
+        RandEvent* event = events_.Get(handle);
+        return (event && !event->finished) ? event : nullptr;
+    }
+    
+    bool Stop(int handle) {
+        // Wheel entries of a stopped event are dropped lazily (serial mismatch)
+        return Get(handle) != nullptr && events_.Remove(handle);
+    }
+    
+    int64_t Remaining(int handle) const {
+        RandEvent* event = Get(handle);
+        return event ? std::max<int64_t>(0, event->due - NowMs()) : -1;
+    }
+    
+    void Process() {
+        int64_t now = NowMs();
+        size_t steps = 0;
+        // Only fully elapsed slots; an event fires at most one slot late
+        while (cursor_ + RESOLUTION_MS <= now && steps < SLOTS) {
+            std::vector<Entry> slot;
+            slot.swap(wheel_[static_cast<size_t>(cursor_ / RESOLUTION_MS) & (SLOTS - 1)]);
+            cursor_ += RESOLUTION_MS;
+            steps++;
+            
+            for (const Entry& entry : slot) {
+                RandEvent* event = Get(entry.handle);
+                if (event == nullptr || event->serial != entry.serial || event->due != entry.due) continue;
+                if (entry.due > now) {
+                    Insert(entry);      // A later revolution
+                    continue;
+                }
+                Fire(entry.handle, *event, now);
+            }
+        }
+        // After a long stall every slot has been visited once; skip ahead and
+        // re-slot what is pending, or entries behind the new cursor would
+        // wait a whole revolution
+        if (cursor_ + RESOLUTION_MS <= now) {
+            cursor_ = now / RESOLUTION_MS * RESOLUTION_MS;
+            std::vector<Entry> pending;
+            for (std::vector<Entry>& slot : wheel_) {
+                pending.insert(pending.end(), slot.begin(), slot.end());
+                slot.clear();
+            }
+            for (const Entry& entry : pending) Insert(entry);
+        }
+    }
+    
+    void ReleaseOwner(void* owner) {
+        for (int handle = 1; handle <= events_.Capacity(); handle++) {
+            RandEvent* event = events_.Get(handle);
+            if (event != nullptr && event->owner == owner) events_.Remove(handle);
+        }
+    }
+};
+
+inline EventScheduler& Events() {
+    static EventScheduler scheduler;
+    return scheduler;
+}
+
+inline bool ValidEventCallback(const char* callback) {
+    return callback != nullptr && callback[0] != '\0' && std::strlen(callback) < 32;
+}
+
+inline int ImplRandEventExponential(void* owner, const char* callback, float meanMs, int arg, int maxFires) {
+    if (!ValidEventCallback(callback) || !(meanMs >= 1.0f) || std::isinf(meanMs) || maxFires < 0) return 0;
+    
+    auto event = std::make_unique<RandEvent>(RandEvent{owner, callback, arg, EventGap::Exponential, meanMs, 0.0, {}, {}, maxFires, 0});
+    return Events().Start(std::move(event));
+}
+
+inline int ImplRandEventUniform(void* owner, const char* callback, int minMs, int maxMs, int arg, int maxFires) {
+    if (!ValidEventCallback(callback) || maxFires < 0) return 0;
+    if (minMs > maxMs) std::swap(minMs, maxMs);
+    if (minMs < 1) return 0;
+    
+    auto event = std::make_unique<RandEvent>(RandEvent{owner, callback, arg, EventGap::Uniform,
+                       static_cast<double>(minMs), static_cast<double>(maxMs), {}, {}, maxFires, 0});
+    return Events().Start(std::move(event));
+}
+
+// Delay delaysMs[i] is drawn with probability weights[i] / sum(weights)
+inline int ImplRandEventCustom(void* owner, const char* callback, const int32_t* delaysMs, const int32_t* weights,
+                               int count, int arg, int maxFires) {
+    if (!ValidEventCallback(callback) || delaysMs == nullptr || weights == nullptr) return 0;
+    if (count <= 0 || count > 100000 || maxFires < 0) return 0;
+    
+    std::vector<double> w(static_cast<size_t>(count));
+    bool any = false;
+    for (int i = 0; i < count; i++) {
+        if (delaysMs[i] < 1 || weights[i] < 0) return 0;
+        w[i] = weights[i];
+        any = any || weights[i] > 0;
+    }
+    if (!any) return 0;
+    
+    auto event = std::make_unique<RandEvent>(RandEvent{owner, callback, arg, EventGap::Custom, 0.0, 0.0,
+                       std::vector<int32_t>(delaysMs, delaysMs + count), {}, maxFires, 0});
+    event->alias.Build(w);
+    return Events().Start(std::move(event));
+}
+
+inline int ImplRandEventRemaining(int handle) {
+    return static_cast<int>(std::min<int64_t>(Events().Remaining(handle), INT_MAX));
+}
+
+inline bool ImplRandEventStop(int handle) {
+    return Events().Stop(handle);
+}
+
+// Called once per server tick, before the callback queue is drained
+inline void ProcessRandEvents() {
+    Events().Process();
+}
+
+// Drop everything a script left running when it unloads
+inline void ReleaseScriptJobs(void* owner) {
+    ReleaseSlicedShuffles(owner);
+    Events().ReleaseOwner(owner);
+    for (int handle = 1; handle <= AsyncJobPool().Capacity(); handle++) {
+        AsyncJob* job = GetAsyncJob(handle);
+        if (job != nullptr && job->owner == owner) ImplRandJobCancel(handle);
+    }
+    PendingCallbacks().DropOwner(owner);
+}